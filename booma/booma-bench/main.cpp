@@ -0,0 +1,543 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include <algorithm>
+#include <ftw.h>
+#include <sys/resource.h>
+
+#include "main.h"
+#include "booma.h"
+#include "boomaapplication.h"
+#include "boomacascadedbiquadfilter.h"
+
+struct BenchReceiver {
+    std::string Name;
+    ReceiverModeType Mode;
+};
+
+void PrintUsage() {
+    std::cout << "Usage: booma-bench [-option [parameter, ...]] file [file ...]" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Runs the complete input-receiver-output chain over the given pcm or wav files" << std::endl;
+    std::cout << "as fast as possible and reports throughput, per-block latency and peak memory." << std::endl;
+    std::cout << std::endl;
+    std::cout << "Receiver(s) to run, can be repeated (default all)        -m CW|AM|SSB|AURORAL" << std::endl;
+    std::cout << "Input datatype (default REAL)                            -it REAL|IQ|I|Q" << std::endl;
+    std::cout << "Original input type                                      -is AUDIO|RTLSDR" << std::endl;
+    std::cout << "Samplerate of the input files (default 48KHz)            -or rate" << std::endl;
+    std::cout << "Frequency (default is the receivers default)             -f frequency" << std::endl;
+    std::cout << "Number of runs for each receiver and file (default 1)    -r runs" << std::endl;
+    std::cout << "Verbose debug output                                     -d" << std::endl;
+    std::cout << "Benchmark the FIR filter kernels and exit                -fb" << std::endl;
+    std::cout << "Check biquad filter against the exact result and exit    -bq" << std::endl;
+    std::cout << "Show this help and exit                                  -h" << std::endl;
+    std::cout << std::endl;
+}
+
+class BenchSink : public HWriter<int16_t> {
+
+    public:
+
+        BenchSink():
+            HWriter<int16_t>("bench_sink") {}
+
+        int Write(int16_t* src, size_t blocksize) {
+            return blocksize;
+        }
+
+        bool Command(HCommand* command) {
+            return true;
+        }
+};
+
+class BenchCapture : public HWriter<int16_t> {
+
+    public:
+
+        std::vector<int16_t> Samples;
+
+        BenchCapture():
+            HWriter<int16_t>("bench_capture") {}
+
+        int Write(int16_t* src, size_t blocksize) {
+            Samples.insert(Samples.end(), src, src + blocksize);
+            return blocksize;
+        }
+
+        bool Command(HCommand* command) {
+            return true;
+        }
+};
+
+// CW receiver IF (6KHz) and output filter coefficients as they were before the
+// filters were designed at runtime, used as the biquad filter regression set
+float BiQuadTables[7][20] =
+{
+    // 50 Hz @ 6KHz
+    {
+        0.002048572294543357, 0.004097144589086714, 0.002048572294543357, 1.408067592516551, -0.9938554560160351,
+        0.0078125, -0.015625, 0.0078125, 1.4116734879341142, -0.9938710552646586,
+        0.0009765625, 0.001953125, 0.0009765625, 1.408045459371766, -0.9974456925740307,
+        0.0078125, -0.015625, 0.0078125, 1.4167508604593735, -0.9974613476810194
+    },
+
+    // 100 Hz @ 6KHz
+    {
+        0.0033509644355716028, 0.0067019288711432055, 0.0033509644355716028, 1.4026434633408733, -0.9883093940592698,
+        0.015625, -0.03125, 0.015625, 1.4095146965221208, -0.9883657437885459,
+        0.001953125, 0.00390625, 0.001953125, 1.4025641509285973, -0.9951244773940543,
+        0.015625, -0.03125, 0.015625, 1.4191527482568658, -0.9951812092261056
+    },
+
+    // 200 Hz @ 6KHz
+    {
+        0.007439398273347204, 0.014878796546694408, 0.007439398273347204, 1.3903155004925956, -0.9759828267704111,
+        0.03125, -0.0625, 0.03125, 1.4044836752325582, -0.9762194821504804,
+        0.00390625, 0.0078125, 0.00390625, 1.3899786395895477, -0.9899122406330527,
+        0.03125, -0.0625, 0.03125, 1.4241834185016982, -0.9901521572645293
+    },
+
+    // 500 Hz @ 6KHz
+    {
+        0.01472079702256931, 0.02944159404513862, 0.01472079702256931, 1.3578013970831393, -0.9429178695624337,
+        0.125, -0.25, 0.125, 1.3918033585781613, -0.9442389046006642,
+        0.0078125, 0.015625, 0.0078125, 1.3559075775374545, -0.9755717421203991,
+        0.0625, -0.125, 0.0625, 1.437988425774804, -0.9769347083141211
+    },
+
+    // 1 KHz @ 6KHz
+    {
+        0.03309018753561541, 0.06618037507123083, 0.03309018753561541, 1.2999716556158074, -0.8820266316104814,
+        0.25, -0.5, 0.25, 1.3714944005456748, -0.8875762227807565,
+        0.015625, 0.03125, 0.015625, 1.2920291704550972, -0.9478234710900391,
+        0.125, -0.25, 0.125, 1.46455173397263, -0.9537131436046499
+    },
+
+    // 3 KHz @ 6KHz
+    {
+        0.1194878224582199, 0.2389756449164398, 0.1194878224582199, 1.1052801524695883, -0.670102919351549,
+        0.5, -1, 0.5, 1.3208341719229677, -0.712714773030205,
+        0.0625, 0.125, 0.0625, 1.0466041855109196, -0.8394505074497361,
+        0.25, -0.5, 0.25, 1.5573059390887027, -0.8869145132418825
+    },
+
+    // 400 Hz @ 1000 Hz (CW output)
+    {
+        0.001780904520508367, 0.003561809041016734, 0.001780904520508367, 1.9305185311207878, -0.9492636159174858,
+        0.5, -1, 0.5, 1.9427984657253758, -0.9565053806179769,
+        0.001953125, 0.00390625, 0.001953125, 1.953016385053386, -0.9766112182691846,
+        0.25, -0.5, 0.25, 1.9726460120356664, -0.9838372084850454
+    }
+};
+
+const char* BiQuadTableNames[7] = {
+    "IF 50Hz", "IF 100Hz", "IF 200Hz", "IF 500Hz", "IF 1KHz", "IF 3KHz", "CW output"
+};
+
+double TimeFilter(HWriter<int16_t>* filter, int16_t* samples, int blocks) {
+
+    // Warm up caches and history before timing
+    for( int i = 0; i < 10; i++ ) {
+        filter->Write(samples, BLOCKSIZE);
+    }
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for( int i = 0; i < blocks; i++ ) {
+        filter->Write(samples, BLOCKSIZE);
+    }
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / blocks;
+}
+
+void PrintFilterResult(int taps, bool isIq, std::string name, double us, double reference) {
+    std::cout << std::left << std::setw(6) << taps << std::setw(6) << (isIq ? "IQ" : "REAL") << std::setw(18) << name
+              << std::right << std::fixed
+              << std::setw(12) << std::setprecision(1) << us
+              << std::setw(12) << std::setprecision(1) << BLOCKSIZE / us
+              << std::setw(10) << std::setprecision(2) << reference / us
+              << std::endl;
+}
+
+void RunFilterBenchmark() {
+
+    // Full scale noise
+    int16_t* samples = new int16_t[BLOCKSIZE];
+    for( int i = 0; i < BLOCKSIZE; i++ ) {
+        samples[i] = (rand() % 65536) - 32768;
+    }
+    int blocks = 2000;
+    BenchSink sink;
+
+    std::cout << std::left << std::setw(6) << "Taps" << std::setw(6) << "Type" << std::setw(18) << "Filter"
+              << std::right
+              << std::setw(12) << "us/block"
+              << std::setw(12) << "MSamples/s"
+              << std::setw(10) << "Speedup"
+              << std::endl;
+
+    int taps[] = {15, 51, 115, 511, 1023};
+    for( int t = 0; t < 5; t++ ) {
+        for( int iq = 0; iq < 2; iq++ ) {
+            float* coefficients = HLowpassKaiserBessel<int16_t>(8000, SAMPLERATE, taps[t], 50).Calculate();
+
+            // The current Hardt filter is the reference
+            HWriter<int16_t>* hardt = iq
+                ? (HWriter<int16_t>*) new HIqFirFilter<int16_t>("bench_hardt_iq_fir", &sink, coefficients, taps[t], BLOCKSIZE)
+                : (HWriter<int16_t>*) new HFirFilter<int16_t>("bench_hardt_fir", &sink, coefficients, taps[t], BLOCKSIZE);
+            double reference = TimeFilter(hardt, samples, blocks);
+            PrintFilterResult(taps[t], iq, iq ? "HIqFirFilter" : "HFirFilter", reference, reference);
+            delete hardt;
+
+            BoomaFirKernel kernels[] = {FIR_KERNEL_SCALAR, FIR_KERNEL_SSE2, FIR_KERNEL_AVX2, FIR_KERNEL_NEON};
+            for( int k = 0; k < 4; k++ ) {
+                if( !BoomaFirFilter::IsSupported(kernels[k]) ) {
+                    continue;
+                }
+                BoomaFirFilter* filter = new BoomaFirFilter("bench_booma_fir", &sink, coefficients, taps[t], BLOCKSIZE, iq, 0, kernels[k]);
+                PrintFilterResult(taps[t], iq, std::string("BoomaFirFilter/") + BoomaFirFilter::GetKernelName(kernels[k]), TimeFilter(filter, samples, blocks), reference);
+                delete filter;
+            }
+
+            // Fast convolution
+            BoomaFirFilter* filter = new BoomaFirFilter("bench_booma_fir_fft", &sink, coefficients, taps[t], BLOCKSIZE, iq, 1);
+            PrintFilterResult(taps[t], iq, "BoomaFirFilter/fft", TimeFilter(filter, samples, blocks), reference);
+            delete filter;
+
+            delete[] coefficients;
+        }
+    }
+    delete[] samples;
+}
+
+// Cascade of direct form I sections in double precision, the exact result
+// that both biquad filters are measured against
+class BenchBiQuadReference {
+
+    private:
+
+        float* _coefficients;
+        int _sections;
+        std::vector<double> _history;
+
+    public:
+
+        BenchBiQuadReference(float* coefficients, int length):
+            _coefficients(coefficients),
+            _sections(length / 5),
+            _history(4 * (length / 5), 0) {}
+
+        // Keeps the history, like the filters do when the number of sections does not change
+        void SetCoefficients(float* coefficients) {
+            _coefficients = coefficients;
+        }
+
+        int Filter(int16_t sample) {
+            double x = sample;
+            for( int s = 0; s < _sections; s++ ) {
+                float* c = &_coefficients[s * 5];
+                double* h = &_history[s * 4];
+                double y = c[0] * x + c[1] * h[0] + c[2] * h[1] + c[3] * h[2] + c[4] * h[3];
+                h[1] = h[0];
+                h[0] = x;
+                h[3] = h[2];
+                h[2] = y;
+                x = y;
+            }
+            return x > 32767 ? 32767 : (x < -32768 ? -32768 : (int) lrint(x));
+        }
+};
+
+bool RunBiQuadRegression() {
+
+    // Noise with a few strong tones in and around the passbands, up to full scale
+    int blocks = 200;
+    int16_t* samples = new int16_t[BLOCKSIZE * blocks];
+    srand(1);
+    for( int i = 0; i < BLOCKSIZE * blocks; i++ ) {
+        double value = (rand() % 8192) - 4096
+            + 12000 * sin(2 * M_PI * 6000 * i / SAMPLERATE)
+            + 8000 * sin(2 * M_PI * 6150 * i / SAMPLERATE)
+            + 4000 * sin(2 * M_PI * 850 * i / SAMPLERATE);
+        samples[i] = value > 32767 ? 32767 : (value < -32768 ? -32768 : (int16_t) value);
+    }
+
+    std::cout << std::left << std::setw(12) << "Filter"
+              << std::right
+              << std::setw(12) << "Samples"
+              << std::setw(14) << "Booma diff"
+              << std::setw(14) << "Hardt diff"
+              << std::endl;
+
+    // Run each table, switching to the next table halfway to cover SetCoefficients(). The
+    // booma filter must stay within one step of the exact result, the difference between
+    // the Hardt filter (which converts to int16 between its sections) and the exact result
+    // is shown for comparison
+    bool passed = true;
+    for( int t = 0; t < 7; t++ ) {
+        BenchCapture hardtOutput;
+        BenchCapture boomaOutput;
+        HCascadedBiQuadFilter<int16_t> hardt("bench_hardt_biquad", &hardtOutput, BiQuadTables[t], 20, BLOCKSIZE);
+        BoomaCascadedBiQuadFilter booma("bench_booma_biquad", &boomaOutput, BiQuadTables[t], 20, BLOCKSIZE);
+        BenchBiQuadReference reference(BiQuadTables[t], 20);
+        std::vector<int> exact;
+        for( int block = 0; block < blocks; block++ ) {
+            if( block == blocks / 2 ) {
+                hardt.SetCoefficients(BiQuadTables[(t + 1) % 7], 20);
+                booma.SetCoefficients(BiQuadTables[(t + 1) % 7], 20);
+                reference.SetCoefficients(BiQuadTables[(t + 1) % 7]);
+            }
+            hardt.Write(&samples[block * BLOCKSIZE], BLOCKSIZE);
+            booma.Write(&samples[block * BLOCKSIZE], BLOCKSIZE);
+            for( int i = 0; i < BLOCKSIZE; i++ ) {
+                exact.push_back(reference.Filter(samples[block * BLOCKSIZE + i]));
+            }
+        }
+
+        int boomaDiff = boomaOutput.Samples.size() == exact.size() ? 0 : 65536;
+        int hardtDiff = hardtOutput.Samples.size() == exact.size() ? 0 : 65536;
+        for( size_t i = 0; i < exact.size(); i++ ) {
+            if( i < boomaOutput.Samples.size() ) {
+                boomaDiff = std::max(boomaDiff, abs(boomaOutput.Samples[i] - exact[i]));
+            }
+            if( i < hardtOutput.Samples.size() ) {
+                hardtDiff = std::max(hardtDiff, abs(hardtOutput.Samples[i] - exact[i]));
+            }
+        }
+        passed = passed && boomaDiff <= 1;
+
+        std::cout << std::left << std::setw(12) << BiQuadTableNames[t]
+                  << std::right
+                  << std::setw(12) << boomaOutput.Samples.size()
+                  << std::setw(14) << boomaDiff
+                  << std::setw(14) << hardtDiff
+                  << std::endl;
+    }
+    delete[] samples;
+
+    std::cout << std::endl << (passed ? "Biquad filter output is within one step of the exact result" : "Biquad filter output differs from the exact result") << std::endl;
+    return passed;
+}
+
+// Peak resident size of the whole process, it never goes down between runs
+long GetPeakRss() {
+    struct rusage usage;
+    if( getrusage(RUSAGE_SELF, &usage) != 0 ) {
+        return 0;
+    }
+    return usage.ru_maxrss;
+}
+
+std::string CreateBenchHome() {
+
+    // Run with a private home so that the users stored configuration is left untouched
+    char path[] = "/tmp/booma-bench-XXXXXX";
+    if( mkdtemp(path) == nullptr ) {
+        return "";
+    }
+    setenv("HOME", path, 1);
+    return std::string(path);
+}
+
+int RemoveBenchHomeEntry(const char* path, const struct stat* sb, int flag, struct FTW* ftw) {
+    return remove(path);
+}
+
+void RemoveBenchHome(std::string home) {
+    if( home.empty() ) {
+        return;
+    }
+
+    // Depth first so that directories are empty when removed, and never follow symlinks
+    if( nftw(home.c_str(), RemoveBenchHomeEntry, 16, FTW_DEPTH | FTW_PHYS) != 0 ) {
+        std::cout << "Unable to remove temporary directory " << home << std::endl;
+    }
+}
+
+BoomaApplication* CreateApplication(std::string file, std::vector<std::string> args, std::string version) {
+
+    // Common arguments: file input, null output and block timing
+    std::vector<std::string> arguments;
+    arguments.push_back("booma-bench");
+    arguments.push_back("-i");
+    arguments.push_back(file.substr(file.find_last_of(".") + 1) == "wav" ? "WAV" : "PCM");
+    arguments.push_back(file);
+    arguments.push_back("-o");
+    arguments.push_back("-1");
+    arguments.push_back("-bt");
+    arguments.insert(arguments.end(), args.begin(), args.end());
+
+    std::vector<char*> argv;
+    for( std::vector<std::string>::iterator it = arguments.begin(); it != arguments.end(); it++ ) {
+        argv.push_back((char*) (*it).c_str());
+    }
+    argv.push_back(nullptr);
+
+    return new BoomaApplication("Booma-Bench", version, argv.size() - 1, argv.data());
+}
+
+void RunReceiver(BoomaApplication* app, BenchReceiver receiver, std::string file, int run, long frequency) {
+
+    // Build the receiver
+    std::cout << std::left << std::setw(10) << receiver.Name << std::setw(4) << run << std::setw(30) << file.substr(file.find_last_of("/") + 1);
+    if( !app->ChangeReceiver(receiver.Mode) || app->IsFaulty() ) {
+        std::cout << "not supported with this input" << std::endl;
+        return;
+    }
+    if( frequency > 0 ) {
+        app->SetFrequency(frequency);
+    }
+
+    // Process the entire file
+    app->Run();
+    app->Wait();
+
+    // Report
+    BoomaBlockTimer* timer = app->GetBlockTimer();
+    if( timer == nullptr || timer->GetElapsed() == 0 ) {
+        std::cout << "no blocks processed" << std::endl;
+        return;
+    }
+    int channels = app->GetInputSourceDataType() == REAL_INPUT_SOURCE_DATA_TYPE ? 1 : 2;
+    double samplesPerSecond = timer->GetSamples() / timer->GetElapsed();
+    std::cout << std::right << std::fixed
+              << std::setw(8) << timer->GetBlocks()
+              << std::setw(14) << std::setprecision(0) << samplesPerSecond
+              << std::setw(9) << std::setprecision(1) << (samplesPerSecond / channels) / app->GetOutputSampleRate()
+              << std::setw(9) << timer->GetLatencyPercentile(50)
+              << std::setw(9) << timer->GetLatencyPercentile(90)
+              << std::setw(9) << timer->GetLatencyPercentile(99)
+              << std::setw(9) << timer->GetMaxLatency()
+              << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    // Initialize Booma
+    std::stringstream ss;
+    ss << "version " << BOOMABENCH_MAJORVERSION << "." << BOOMABENCH_MINORVERSION << "." << BOOMABENCH_BUILDNO;
+
+    // Parse arguments
+    std::vector<BenchReceiver> receivers;
+    std::vector<std::string> files;
+    std::vector<std::string> args;
+    int runs = 1;
+    long frequency = 0;
+    for( int i = 1; i < argc; i++ ) {
+        if( strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0 ) {
+            PrintUsage();
+            return 0;
+        }
+        if( strcmp(argv[i], "-m") == 0 && i < argc - 1 ) {
+            if( strcmp(argv[i + 1], "CW") == 0 ) {
+                receivers.push_back({"CW", CW});
+            } else if( strcmp(argv[i + 1], "AM") == 0 ) {
+                receivers.push_back({"AM", AM});
+            } else if( strcmp(argv[i + 1], "SSB") == 0 ) {
+                receivers.push_back({"SSB", SSB});
+            } else if( strcmp(argv[i + 1], "AURORAL") == 0 ) {
+                receivers.push_back({"AURORAL", AURORAL});
+            } else {
+                std::cout << "Unknown receiver type " << argv[i + 1] << std::endl;
+                return 1;
+            }
+            i++;
+            continue;
+        }
+        if( (strcmp(argv[i], "-it") == 0 || strcmp(argv[i], "-is") == 0 || strcmp(argv[i], "-or") == 0) && i < argc - 1 ) {
+            args.push_back(argv[i]);
+            args.push_back(argv[i + 1]);
+            i++;
+            continue;
+        }
+        if( strcmp(argv[i], "-f") == 0 && i < argc - 1 ) {
+            frequency = atol(argv[i + 1]);
+            i++;
+            continue;
+        }
+        if( strcmp(argv[i], "-r") == 0 && i < argc - 1 ) {
+            runs = atoi(argv[i + 1]);
+            i++;
+            continue;
+        }
+        if( strcmp(argv[i], "-d") == 0 ) {
+            args.push_back(argv[i]);
+            continue;
+        }
+        if( strcmp(argv[i], "-fb") == 0 ) {
+            std::cout << "booma-bench " << ss.str() << std::endl << std::endl;
+            RunFilterBenchmark();
+            return 0;
+        }
+        if( strcmp(argv[i], "-bq") == 0 ) {
+            std::cout << "booma-bench " << ss.str() << std::endl << std::endl;
+            return RunBiQuadRegression() ? 0 : 1;
+        }
+        if( argv[i][0] == '-' ) {
+            std::cout << "Unknown parameter '" << argv[i] << "' (use '-h' to show the help)" << std::endl;
+            return 1;
+        }
+        files.push_back(argv[i]);
+    }
+    if( files.empty() ) {
+        PrintUsage();
+        return 1;
+    }
+    if( receivers.empty() ) {
+        receivers.push_back({"CW", CW});
+        receivers.push_back({"AM", AM});
+        receivers.push_back({"SSB", SSB});
+        receivers.push_back({"AURORAL", AURORAL});
+    }
+
+    std::string home = CreateBenchHome();
+    if( home.empty() ) {
+        std::cout << "Unable to create temporary directory for the benchmark configuration" << std::endl;
+        return 1;
+    }
+
+    try {
+        std::cout << "booma-bench " << ss.str() << std::endl << std::endl;
+        std::cout << std::left << std::setw(10) << "Receiver" << std::setw(4) << "#" << std::setw(30) << "File"
+                  << std::right
+                  << std::setw(8) << "Blocks"
+                  << std::setw(14) << "Samples/s"
+                  << std::setw(9) << "xRT"
+                  << std::setw(9) << "p50(us)"
+                  << std::setw(9) << "p90(us)"
+                  << std::setw(9) << "p99(us)"
+                  << std::setw(9) << "max(us)"
+                  << std::endl;
+
+        for( std::vector<std::string>::iterator file = files.begin(); file != files.end(); file++ ) {
+            BoomaApplication* app = CreateApplication(*file, args, ss.str());
+            for( std::vector<BenchReceiver>::iterator receiver = receivers.begin(); receiver != receivers.end(); receiver++ ) {
+                for( int run = 1; run <= runs; run++ ) {
+                    RunReceiver(app, *receiver, *file, run, frequency);
+                }
+            }
+            delete app;
+        }
+
+        // Reported once since the peak covers all runs in this process
+        std::cout << std::endl << "Peak RSS for all runs: " << GetPeakRss() << " kB" << std::endl;
+    }
+    catch( BoomaException *boomaException ) {
+        HError("Caught BoomaException: %s", boomaException->what());
+        std::cout << "Caught unexpected internal exception (" << boomaException->What() << ")" << std::endl;
+        RemoveBenchHome(home);
+        return 1;
+    }
+    catch( ... ) {
+        HError("Caught unknown exception");
+        std::cout << "Caught unknown exception" << std::endl;
+        RemoveBenchHome(home);
+        return 1;
+    }
+
+    // Leave peacefully
+    RemoveBenchHome(home);
+    return 0;
+}
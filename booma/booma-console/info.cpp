@@ -1,7 +1,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <iostream>
+#include <iomanip>
 #include <math.h>
+#include <thread>
+#include <chrono>
 #include <booma.h>
 
 #include "info.h"
@@ -61,19 +64,87 @@ void Info::GetInfo() {
     // Signallevel
     std::cout << "Average signallevel: S" << _app->GetSignalLevel() << std::endl;
     std::cout << "Average signal measurement: " << _app->GetSignalSum() << std::endl;
+    if( _app->GetDroppedInputBlocks() > 0 ) {
+        std::cout << "Dropped input blocks: " << _app->GetDroppedInputBlocks() << std::endl;
+    }
+    if( _app->GetDroppedDumpBlocks() > 0 ) {
+        std::cout << "Dropped dump blocks: " << _app->GetDroppedDumpBlocks() << std::endl;
+    }
+    if( _app->GetTimeShiftMemoryPerMinute() > 0 ) {
+        std::cout << "Time shift: " << _app->GetTimeShiftDelay() << " seconds behind live, catch up speed " << _app->GetTimeShiftCatchUpSpeed() << "x, " << (_app->GetTimeShiftMemoryPerMinute() / (1024 * 1024)) << " MB per minute" << std::endl;
+    }
     std::cout << std::endl;
 
-    // RF spectrum
+    // Spectrums are only calculated while they are being read, so keep
+    // polling until fresh spectrums are ready (or give up after 2 seconds)
     double rfSpectrum[_app->GetRfFftSize()];
-    int rfN = _app->GetRfSpectrum(rfSpectrum);
+    double audioSpectrum[_app->GetAudioFftSize()];
+    unsigned long rfSequence = 0;
+    unsigned long audioSequence = 0;
+    _app->GetRfSpectrum(rfSpectrum, _app->GetRfFftSize(), &rfSequence);
+    _app->GetAudioSpectrum(audioSpectrum, _app->GetAudioFftSize(), &audioSequence);
+    int rfN = 0;
+    int audioN = 0;
+    for( int i = 0; i < 20 && (rfN == 0 || audioN == 0); i++ ) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if( rfN == 0 ) {
+            rfN = _app->GetRfSpectrum(rfSpectrum, _app->GetRfFftSize(), &rfSequence);
+        }
+        if( audioN == 0 ) {
+            audioN = _app->GetAudioSpectrum(audioSpectrum, _app->GetAudioFftSize(), &audioSequence);
+        }
+    }
+
+    // RF spectrum
     Spectrum("RF spectrum", 48000, rfSpectrum, rfN, _app->GetFrequency());
     std::cout << std::endl;
 
     // Audio spectrum
-    double audioSpectrum[_app->GetAudioFftSize()];
-    int audioN = _app->GetAudioSpectrum(audioSpectrum);
     Spectrum("Audio spectrum", 48000, audioSpectrum, audioN);
     std::cout << std::endl;
+
+    // Stage profiling
+    std::vector<StageStatistics> stages = _app->GetStageStatistics();
+    if( !stages.empty() ) {
+        Stages(stages);
+        std::cout << std::endl;
+    }
+
+    // Latency
+    std::vector<LatencyStatistics> latencies = _app->GetLatencyStatistics();
+    if( !latencies.empty() ) {
+        Latencies(latencies);
+        std::cout << std::endl;
+    }
+}
+
+void Info::Latencies(std::vector<LatencyStatistics> latencies) {
+    std::cout << "Latency from input device:" << std::endl;
+    std::cout << std::left << std::setw(52) << "Point" << std::right << std::setw(10) << "Blocks" << std::setw(12) << "Min(ms)" << std::setw(12) << "Avg(ms)" << std::setw(12) << "P99(ms)" << std::setw(12) << "Max(ms)" << std::endl;
+    for( std::vector<LatencyStatistics>::iterator it = latencies.begin(); it != latencies.end(); it++ ) {
+        std::cout << std::left << std::setw(52) << (*it).Name
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << (*it).Count
+                  << std::setw(12) << (*it).Min
+                  << std::setw(12) << (*it).Avg
+                  << std::setw(12) << (*it).P99
+                  << std::setw(12) << (*it).Max
+                  << std::endl;
+    }
+}
+
+void Info::Stages(std::vector<StageStatistics> stages) {
+    std::cout << "Stage timing:" << std::endl;
+    std::cout << std::left << std::setw(52) << "Stage" << std::right << std::setw(10) << "Calls" << std::setw(14) << "Total(ms)" << std::setw(12) << "Avg(us)" << std::setw(12) << "Max(us)" << std::endl;
+    for( std::vector<StageStatistics>::iterator it = stages.begin(); it != stages.end(); it++ ) {
+        std::cout << std::left << std::setw(52) << (*it).Name
+                  << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(10) << (*it).Calls
+                  << std::setw(14) << (*it).Total / 1000
+                  << std::setw(12) << ((*it).Calls > 0 ? (*it).Total / (*it).Calls : 0)
+                  << std::setw(12) << (*it).Max
+                  << std::endl;
+    }
 }
 
 void Info::Spectrum(std::string name, int fSample, double* spectrum, int n, int frequencyMarker) {
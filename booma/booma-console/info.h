@@ -14,6 +14,8 @@ class Info {
 
         BoomaApplication* _app;
         void Spectrum(std::string name, int fSample, double* spectrum, int n, int frequencyMarker = 0);
+        void Stages(std::vector<StageStatistics> stages);
+        void Latencies(std::vector<LatencyStatistics> latencies);
 
     public:
 
@@ -135,7 +135,7 @@ int main(int argc, char** argv) {
             else
             {
                 // Does the command requires an option ?
-                if( cmd == 'f' || cmd == 'g' || cmd == 'v' || cmd == 'r' || cmd == 'o' || cmd == 'b' || cmd == 'c' || cmd == 'd' || cmd == 'w' || cmd == 'e' || cmd == 'z' || cmd == 'n' || cmd == 'u' ) {
+                if( cmd == 'f' || cmd == 'g' || cmd == 'v' || cmd == 'r' || cmd == 'o' || cmd == 'b' || cmd == 'c' || cmd == 'd' || cmd == 'w' || cmd == 'e' || cmd == 'z' || cmd == 'n' || cmd == 'u' || cmd == 'y' ) {
                     std::cin >> opt;
                 }
                 else
@@ -197,6 +197,16 @@ int main(int argc, char** argv) {
                 app.ToggleDumpAudio();
             }
 
+            // Rewind the time shift buffer, or return to live input
+            else if( cmd == 'y' ) {
+                int seconds = atoi(opt.c_str());
+                if( seconds > 0 ? !app.Rewind(seconds) : !app.GoLive() ) {
+                    std::cout << "No time shift buffer (enable with -ts seconds)" << std::endl;
+                } else {
+                    std::cout << "Time shift " << app.GetTimeShiftDelay() << " seconds behind live, " << (app.GetTimeShiftMemoryPerMinute() / (1024 * 1024)) << " MB per minute" << std::endl;
+                }
+            }
+
             // Increase/decrease rf gain
             else if( cmd == 'g' ) {
                 if( !app.GetRfGainEnabled() ) {
@@ -363,6 +373,7 @@ int main(int argc, char** argv) {
                 std::cout << "Set receiver option:                o <NAME=VALUE>" << std::endl;
                 std::cout << "Toggle audio recording on/off:      u" << std::endl;
                 std::cout << "Toggle rf recording on/off:         p" << std::endl;
+                std::cout << "Rewind time shift buffer:           y <seconds> or y 0 (return to live)" << std::endl;
                 std::cout << "Enter measurement mode:             m" << std::endl;
                 std::cout << "Restart current receiver:           s" << std::endl;
                 std::cout << "Get configuration sections:         t" << std::endl;
@@ -45,6 +45,10 @@ class Analysis : public Fl_Widget {
             return _fft;
         }
 
+        int GetFftBufferSize() {
+            return _n;
+        }
+
         void SetType( AnalysisType type ) {
             _type = type;
         }
@@ -131,6 +131,11 @@ class MainWindow {
         inline void UpdateRfSpectrumDisplay();
         inline void UpdateAfSpectrumDisplay();
 
+        // Last spectrum shown in each display, to skip redrawing unchanged spectrums
+        unsigned long _rfSpectrumSequence = 0;
+        unsigned long _afSpectrumSequence = 0;
+        unsigned long _analysisSequence = 0;
+
         void Run();
         void Halt();
 
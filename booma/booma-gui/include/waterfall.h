@@ -78,6 +78,10 @@ class Waterfall : public Fl_Widget {
             return _fft;
         }
 
+        int GetFftBufferSize() {
+            return _n;
+        }
+
         void Refresh();
 
         void callback(Fl_Callback0* cb) {
@@ -182,7 +182,11 @@ MainWindow::MainWindow(BoomaApplication* app):
             std::this_thread::sleep_for(std::chrono::milliseconds(200));
             if( !_threadsPaused ) {
                 Fl::lock();
-                UpdateRfSpectrumDisplay();
+
+                // Skip reading while minimized so that the spectrum calculation stops
+                if( _win->visible() ) {
+                    UpdateRfSpectrumDisplay();
+                }
                 Fl::unlock();
                 Fl::awake();
             }
@@ -196,7 +200,11 @@ MainWindow::MainWindow(BoomaApplication* app):
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
             if( !_threadsPaused ) {
                 Fl::lock();
-                UpdateAfSpectrumDisplay();
+
+                // Skip reading while minimized so that the spectrum calculation stops
+                if( _win->visible() ) {
+                    UpdateAfSpectrumDisplay();
+                }
                 Fl::unlock();
                 Fl::awake();
             }
@@ -1404,16 +1412,19 @@ inline void MainWindow::UpdateSignalLevelDisplay() {
 }
 
 inline void MainWindow::UpdateRfSpectrumDisplay() {
-    _app->GetRfSpectrum(_rfInputWaterfall->GetFftBuffer());
-    _rfInputWaterfall->Refresh();
+    if( _app->GetRfSpectrum(_rfInputWaterfall->GetFftBuffer(), _rfInputWaterfall->GetFftBufferSize(), &_rfSpectrumSequence) > 0 ) {
+        _rfInputWaterfall->Refresh();
+    }
 }
 
 inline void MainWindow::UpdateAfSpectrumDisplay() {
-    _app->GetAudioSpectrum(_afOutputWaterfall->GetFftBuffer());
-    _afOutputWaterfall->Refresh();
+    if( _app->GetAudioSpectrum(_afOutputWaterfall->GetFftBuffer(), _afOutputWaterfall->GetFftBufferSize(), &_afSpectrumSequence) > 0 ) {
+        _afOutputWaterfall->Refresh();
+    }
 
-    _app->GetAudioSpectrum(_analysis->GetFftBuffer());
-    _analysis->Refresh();
+    if( _app->GetAudioSpectrum(_analysis->GetFftBuffer(), _analysis->GetFftBufferSize(), &_analysisSequence) > 0 ) {
+        _analysis->Refresh();
+    }
 }
 
 void MainWindow::Run() {
@@ -1,4 +1,5 @@
 #include "boomaamreceiver.h"
+#include "boomakaiserbesseldesigner.h"
 
 BoomaAmReceiver::BoomaAmReceiver(ConfigOptions* opts, int initialFrequency):
         BoomaReceiver(opts, initialFrequency),
@@ -8,7 +9,7 @@ BoomaAmReceiver::BoomaAmReceiver(ConfigOptions* opts, int initialFrequency):
 HWriterConsumer<int16_t>* BoomaAmReceiver::PreProcess(ConfigOptions* opts, HWriterConsumer<int16_t>* previous) {
     HLog("Creating AM receiver preprocessing chain");
 
-    _inputFirFilter = new HIqFirFilter<int16_t>("am_receiver_preprocess_iq_fir", previous, HLowpassKaiserBessel<int16_t>(8000, opts->GetOutputSampleRate(), 25, 50).Calculate(), 25, BLOCKSIZE);
+    _inputFirFilter = new HIqFirFilter<int16_t>("am_receiver_preprocess_iq_fir", Profile("am_receiver_preprocess_iq_fir", previous), BoomaKaiserBesselDesigner::Lowpass(8000, opts->GetOutputSampleRate(), 25, 50).data(), 25, opts->GetBlocksize());
 
     return _inputFirFilter->Consumer();
 }
@@ -20,12 +21,12 @@ HWriterConsumer<int16_t>* BoomaAmReceiver::Receive(ConfigOptions* opts, HWriterC
     // frequency equal to the received center frequency, so demodulate AM from an IQ signal by
     // taking the absolute amplitude
     HLog("Demodulating AM by way of absolute value of IQ signal at time 't'");
-    _absConverter = new HIq2AbsConverter<int16_t>("am_receiver_abs_converter", previous, BLOCKSIZE);
+    _absConverter = new HIq2AbsConverter<int16_t>("am_receiver_abs_converter", Profile("am_receiver_abs_converter", previous), opts->GetBlocksize());
 
     // Since the absolute-converter above returns only half the samples (takes a complex sample, returns
     // the magniture) we need to collect two blocks to get back to the original block size
-    HLog("Collecting two blocks to reconstruct blocksize %d", BLOCKSIZE);
-    _collector = new HCollector<int16_t>("am_receiver_block_collector", _absConverter->Consumer(), BLOCKSIZE / 2, BLOCKSIZE);
+    HLog("Collecting two blocks to reconstruct blocksize %d", opts->GetBlocksize());
+    _collector = new HCollector<int16_t>("am_receiver_block_collector", Profile("am_receiver_block_collector", _absConverter->Consumer()), opts->GetBlocksize() / 2, opts->GetBlocksize());
 
     // End of receiving
     return _collector->Consumer();
@@ -34,7 +35,7 @@ HWriterConsumer<int16_t>* BoomaAmReceiver::Receive(ConfigOptions* opts, HWriterC
 HWriterConsumer<int16_t>* BoomaAmReceiver::PostProcess(ConfigOptions* opts, HWriterConsumer<int16_t>* previous) {
     HLog("Creating AM receiver postprocessing chain");
 
-    _outputFilter = new HBiQuadFilter<HLowpassBiQuad<int16_t>, int16_t>("am_receiver_post_process_bi_quad", previous, 3000, opts->GetOutputSampleRate(), 0.707, 1, BLOCKSIZE);
+    _outputFilter = new HBiQuadFilter<HLowpassBiQuad<int16_t>, int16_t>("am_receiver_post_process_bi_quad", Profile("am_receiver_post_process_bi_quad", previous), 3000, opts->GetOutputSampleRate(), 0.707, 1, opts->GetBlocksize());
 
     return _outputFilter->Consumer();
 }
@@ -3,7 +3,9 @@
 #include "boomacwreceiver.h"
 #include "boomaauroralreceiver.h"
 #include "boomassbreceiver.h"
+#include "boomamemory.h"
 #include "booma.h"
+#include "boomakaiserbesseldesigner.h"
 
 BoomaApplication::BoomaApplication(std::string appName, std::string appVersion, int argc, char** argv):
     _opts(NULL),
@@ -11,6 +13,8 @@ BoomaApplication::BoomaApplication(std::string appName, std::string appVersion,
     _input(NULL),
     _receiver(NULL),
     _output(NULL),
+    _channelSplitter(NULL),
+    _channelizer(NULL),
     _isRunning(false) {
 
     // Initialize the Hardt toolkit.
@@ -22,6 +26,14 @@ BoomaApplication::BoomaApplication(std::string appName, std::string appVersion,
     // Parse input arguments
     _opts = new ConfigOptions(appName, appVersion, argc, argv);
 
+    // Reserve the pool for the working buffers before the first chain is built
+    if( _opts->GetMemoryPool() > 0 ) {
+        BoomaMemory::Reserve((size_t) _opts->GetMemoryPool() << 20, _opts->GetMemoryPoolHugePages(), _opts->GetMemoryPoolLock());
+    }
+
+    // Reuse filter designs from previous runs
+    BoomaKaiserBesselDesigner::SetPersistent(_opts->GetPersistFilterDesigns());
+
     // Initialize receiver
     if( !InitializeReceiver() ) {
         HError("Failed to create receiver, check the log");
@@ -43,6 +55,10 @@ BoomaApplication::~BoomaApplication() {
 
     // Reset all previous receiver components
     HLog("Reset receiver components");
+    ResetChannelReceivers();
+    for( std::vector<BoomaChannelReceiver*>::iterator it = _channelReceivers.begin(); it != _channelReceivers.end(); it++ ) {
+        delete (*it);
+    }
     if( _input != NULL ) {
         delete _input;
         _input = NULL;
@@ -68,6 +84,7 @@ bool BoomaApplication::Reconfigure() {
     Halt();
 
     // Reset all previous receiver components
+    ResetChannelReceivers();
     if( _input != NULL ) {
         delete _input;
         _input = NULL;
@@ -178,6 +195,12 @@ bool BoomaApplication::InitializeReceiver() {
             return true;
         }
 
+        // Split off a channelizer if we have channel receivers
+        HWriterConsumer<int16_t>* source = _input->GetLastWriterConsumer();
+        if( !_channelReceivers.empty() ) {
+            source = SetChannelReceivers(source);
+        }
+
         // Create receiver
         try {
             switch (_opts->GetReceiverModeType()) {
@@ -217,7 +240,7 @@ bool BoomaApplication::InitializeReceiver() {
             } else {
                 HLog("Initial frequency %d is valid for the selected receiver", _opts->GetFrequency());
             }
-            _receiver->Build(_opts, _input);
+            _receiver->Build(_opts, source);
         } catch( BoomaReceiverException e ) {
             HError("Failed to build receiver '%s', config is faulty", e.What().c_str());
             _opts->SetFaulty(true);
@@ -230,13 +253,18 @@ bool BoomaApplication::InitializeReceiver() {
 
         // Setup output
         try {
-            _output = new BoomaOutput(_opts, _receiver);
+            _output = new BoomaOutput(_opts, _receiver, _input->GetLatency());
         } catch( ... ) {
             HError("Failed to initialize output, unexpected exception was thrown. Config is faulty");
             _opts->SetFaulty(true);
             return false;
         }
 
+        // The signal level trigger (if any) also controls the rf dump
+        if( _output->GetTrigger() != nullptr ) {
+            _output->GetTrigger()->Arm(_input->GetRfBreaker(), _opts->GetDumpRf());
+        }
+
         // Set frequency - important when using a remote receiver
         SetFrequency(_opts->GetFrequency());
     }
@@ -247,6 +275,7 @@ bool BoomaApplication::InitializeReceiver() {
     }
 
     // Complete input-receiver-output chain configured
+    HLog("Working buffers in use %lu KB, peak %lu KB, pool %lu KB", BoomaMemory::GetInUse() >> 10, BoomaMemory::GetPeak() >> 10, BoomaMemory::GetPoolSize() >> 10);
     return true;
 }
 
@@ -264,6 +293,13 @@ bool BoomaApplication::SetFrequency(long int frequency) {
     // Tune the input and the receiver
     if( _input->SetFrequency(_opts, frequency) && _receiver->SetFrequency(_opts, _input->GetIfFrequency()) ) {
         _opts->SetFrequency(frequency);
+
+        // Channel receivers stay on their own frequency
+        if( _channelizer != NULL ) {
+            for( std::vector<BoomaChannelReceiver*>::iterator it = _channelReceivers.begin(); it != _channelReceivers.end(); it++ ) {
+                (*it)->SetFrequency(_opts, _channelizer);
+            }
+        }
         return true;
     }
 
@@ -306,6 +342,10 @@ bool BoomaApplication::ToggleDumpRf() {
         return false;
     }
 
+    if( _output != nullptr && _output->GetTrigger() != nullptr ) {
+        _opts->SetDumpRf( _output->GetTrigger()->Arm(_input->GetRfBreaker(), !_opts->GetDumpRf()) );
+        return true;
+    }
     _opts->SetDumpRf( _input->SetDumpRf(!_opts->GetDumpRf()) );
     return true;
 }
@@ -327,6 +367,17 @@ bool BoomaApplication::GetDumpAudio() {
     return _opts->GetDumpAudio();
 }
 
+bool BoomaApplication::GetDumpTriggered() {
+    return _output != nullptr && _output->GetTrigger() != nullptr && _output->GetTrigger()->IsTriggered();
+}
+
+unsigned long BoomaApplication::GetDroppedDumpBlocks() {
+    if( _input == nullptr || _output == nullptr ) {
+        return 0;
+    }
+    return _input->GetDroppedDumpBlocks() + _output->GetDroppedDumpBlocks();
+}
+
 bool BoomaApplication::SetRfGain(int gain) {
     if( IsFaulty() ) {
         return false;
@@ -334,6 +385,9 @@ bool BoomaApplication::SetRfGain(int gain) {
 
     _opts->SetRfGain(gain);
     _receiver->SetRfGain(_opts->GetRfGain());
+    if( _input->GetRfRecorder() != nullptr ) {
+        _input->GetRfRecorder()->SetGain(_opts->GetRfGain());
+    }
     return true;
 }
 
@@ -365,22 +419,194 @@ int BoomaApplication::GetRfFftSize() {
     return _input != nullptr ? _input->GetRfFftSize() : 0;
 }
 
-int BoomaApplication::GetRfSpectrum(double* spectrum) {
+int BoomaApplication::GetRfSpectrum(double* spectrum, int size, unsigned long* sequence) {
     if( spectrum == nullptr ) {
         HError("RF spectrum destination buffer is null");
     }
-    return _input != nullptr ? _input->GetRfSpectrum(spectrum) : 0;
+    return _input != nullptr ? _input->GetRfSpectrum(spectrum, size, sequence) : 0;
 }
 
 int BoomaApplication::GetAudioFftSize() {
     return _output != nullptr ? _output->GetAudioFftSize() : 0;
 }
 
-int BoomaApplication::GetAudioSpectrum(double* spectrum) {
+int BoomaApplication::GetAudioSpectrum(double* spectrum, int size, unsigned long* sequence) {
     if( spectrum == nullptr ) {
         HError("Audio spectrum destination buffer is null");
     }
-    return _output != nullptr ? _output->GetAudioSpectrum(spectrum) : 0;
+    return _output != nullptr ? _output->GetAudioSpectrum(spectrum, size, sequence) : 0;
+}
+
+bool BoomaApplication::SetRfFftSize(int size) {
+    if( IsFaulty() || _input == nullptr || !_input->SetRfSpectrum(size, _opts->GetRfFftOverlap(), _opts->GetRfFftAveraging()) ) {
+        return false;
+    }
+    _opts->SetRfFftSize(size);
+    return true;
+}
+
+int BoomaApplication::GetRfFftOverlap() {
+    return _opts->GetRfFftOverlap();
+}
+
+bool BoomaApplication::SetRfFftOverlap(int overlap) {
+    if( IsFaulty() || _input == nullptr || !_input->SetRfSpectrum(_opts->GetRfFftSize(), overlap, _opts->GetRfFftAveraging()) ) {
+        return false;
+    }
+    _opts->SetRfFftOverlap(overlap);
+    return true;
+}
+
+int BoomaApplication::GetRfFftAveraging() {
+    return _opts->GetRfFftAveraging();
+}
+
+bool BoomaApplication::SetRfFftAveraging(int averaging) {
+    if( IsFaulty() || _input == nullptr || !_input->SetRfSpectrum(_opts->GetRfFftSize(), _opts->GetRfFftOverlap(), averaging) ) {
+        return false;
+    }
+    _opts->SetRfFftAveraging(averaging);
+    return true;
+}
+
+bool BoomaApplication::SetAudioFftSize(int size) {
+    if( IsFaulty() || _output == nullptr || !_output->SetAudioSpectrum(size, _opts->GetAfFftOverlap(), _opts->GetAfFftAveraging()) ) {
+        return false;
+    }
+    _opts->SetAfFftSize(size);
+    return true;
+}
+
+int BoomaApplication::GetAudioFftOverlap() {
+    return _opts->GetAfFftOverlap();
+}
+
+bool BoomaApplication::SetAudioFftOverlap(int overlap) {
+    if( IsFaulty() || _output == nullptr || !_output->SetAudioSpectrum(_opts->GetAfFftSize(), overlap, _opts->GetAfFftAveraging()) ) {
+        return false;
+    }
+    _opts->SetAfFftOverlap(overlap);
+    return true;
+}
+
+int BoomaApplication::GetAudioFftAveraging() {
+    return _opts->GetAfFftAveraging();
+}
+
+bool BoomaApplication::SetAudioFftAveraging(int averaging) {
+    if( IsFaulty() || _output == nullptr || !_output->SetAudioSpectrum(_opts->GetAfFftSize(), _opts->GetAfFftOverlap(), averaging) ) {
+        return false;
+    }
+    _opts->SetAfFftAveraging(averaging);
+    return true;
+}
+
+std::vector<StageStatistics> BoomaApplication::GetStageStatistics() {
+    std::vector<StageStatistics> statistics;
+    if( _input != nullptr ) {
+        std::vector<StageStatistics> input = _input->GetStageStatistics();
+        statistics.insert(statistics.end(), input.begin(), input.end());
+    }
+    if( _receiver != nullptr ) {
+        std::vector<StageStatistics> receiver = _receiver->GetStageStatistics();
+        statistics.insert(statistics.end(), receiver.begin(), receiver.end());
+    }
+    if( _output != nullptr ) {
+        std::vector<StageStatistics> output = _output->GetStageStatistics();
+        statistics.insert(statistics.end(), output.begin(), output.end());
+    }
+    return statistics;
+}
+
+std::vector<LatencyStatistics> BoomaApplication::GetLatencyStatistics() {
+    if( _input == nullptr ) {
+        return std::vector<LatencyStatistics>();
+    }
+    return _input->GetLatency()->GetStatistics();
+}
+
+bool BoomaApplication::Rewind(int seconds) {
+    if( _input == nullptr || _input->GetTimeShift() == nullptr ) {
+        return false;
+    }
+    return _input->GetTimeShift()->Rewind(seconds);
+}
+
+bool BoomaApplication::GoLive() {
+    if( _input == nullptr || _input->GetTimeShift() == nullptr ) {
+        return false;
+    }
+    _input->GetTimeShift()->GoLive();
+    return true;
+}
+
+double BoomaApplication::GetTimeShiftDelay() {
+    if( _input == nullptr || _input->GetTimeShift() == nullptr ) {
+        return 0;
+    }
+    return _input->GetTimeShift()->GetDelay();
+}
+
+double BoomaApplication::GetTimeShiftMemoryPerMinute() {
+    if( _input == nullptr || _input->GetTimeShift() == nullptr ) {
+        return 0;
+    }
+    return _input->GetTimeShift()->GetMemoryPerMinute();
+}
+
+double BoomaApplication::GetTimeShiftCatchUpSpeed() {
+    if( _input == nullptr || _input->GetTimeShift() == nullptr ) {
+        return 0;
+    }
+    return _input->GetTimeShift()->GetCatchUpSpeed();
+}
+
+bool BoomaApplication::SeekInput(double seconds) {
+    if( _input == nullptr || _input->GetFileReader() == nullptr ) {
+        return false;
+    }
+    return _input->GetFileReader()->Seek(seconds);
+}
+
+double BoomaApplication::GetInputPosition() {
+    if( _input == nullptr || _input->GetFileReader() == nullptr ) {
+        return 0;
+    }
+    return _input->GetFileReader()->GetPosition();
+}
+
+double BoomaApplication::GetInputLength() {
+    if( _input == nullptr || _input->GetFileReader() == nullptr ) {
+        return 0;
+    }
+    return _input->GetFileReader()->GetLength();
+}
+
+float BoomaApplication::GetInputSpeed() {
+    return _opts->GetInputFileSpeed();
+}
+
+bool BoomaApplication::SetInputSpeed(float speed) {
+    if( speed < 0 ) {
+        return false;
+    }
+    _opts->SetInputFileSpeed(speed);
+    if( _input != nullptr && _input->GetFileReader() != nullptr ) {
+        _input->GetFileReader()->SetSpeed(speed);
+    }
+    return true;
+}
+
+bool BoomaApplication::GetInputLoop() {
+    return _opts->GetInputFileLoop();
+}
+
+bool BoomaApplication::SetInputLoop(bool loop) {
+    _opts->SetInputFileLoop(loop);
+    if( _input != nullptr && _input->GetFileReader() != nullptr ) {
+        _input->GetFileReader()->SetLoop(loop);
+    }
+    return true;
 }
 
 InputSourceType BoomaApplication::GetInputSourceType() {
@@ -539,6 +765,98 @@ bool BoomaApplication::UseChannel(int id) {
     return false;
 }
 
+HWriterConsumer<int16_t>* BoomaApplication::SetChannelReceivers(HWriterConsumer<int16_t>* previous) {
+
+    // Channels are taken from the IQ spectrum centered at the tuned frequency
+    if( _opts->GetInputSourceDataType() != IQ_INPUT_SOURCE_DATA_TYPE || _input->GetIfFrequency() != 0 ) {
+        HError("Channel receivers requires an IQ input with the tuned frequency at 0Hz");
+        throw new BoomaConfigurationException("Channel receivers requires IQ input");
+    }
+
+    // The main receiver and the channelizer both gets the input
+    HLog("Creating channelizer for %d channel receivers", (int) _channelReceivers.size());
+    _channelSplitter = new BoomaSplitter("channel_splitter", previous, _opts->GetBlocksize());
+    int channels = _opts->GetChannelizerChannels();
+    _channelizer = new BoomaChannelizer("channelizer", _channelSplitter->Consumer(), _opts->GetOutputSampleRate(), channels,
+                                        BoomaKaiserBesselDesigner::Lowpass(0.75 * _opts->GetOutputSampleRate() / channels, _opts->GetOutputSampleRate(), channels * CHANNELIZER_TAPS_PER_CHANNEL, 60).data(),
+                                        channels * CHANNELIZER_TAPS_PER_CHANNEL, _opts->GetBlocksize());
+    for( std::vector<BoomaChannelReceiver*>::iterator it = _channelReceivers.begin(); it != _channelReceivers.end(); it++ ) {
+        (*it)->Build(_opts, _channelizer);
+    }
+
+    return _channelSplitter->Consumer();
+}
+
+void BoomaApplication::ResetChannelReceivers() {
+    for( std::vector<BoomaChannelReceiver*>::iterator it = _channelReceivers.begin(); it != _channelReceivers.end(); it++ ) {
+        (*it)->Reset();
+    }
+    if( _channelizer != NULL ) {
+        delete _channelizer;
+        _channelizer = NULL;
+    }
+    if( _channelSplitter != NULL ) {
+        delete _channelSplitter;
+        _channelSplitter = NULL;
+    }
+}
+
+bool BoomaApplication::AddChannelReceiver(long int frequency, ReceiverModeType receiverModeType, std::string outputFilename) {
+    for( std::vector<BoomaChannelReceiver*>::iterator it = _channelReceivers.begin(); it != _channelReceivers.end(); it++ ) {
+        if( (*it)->GetFrequency() == frequency ) {
+            HLog("Already have a channel receiver for %ld", frequency);
+            return false;
+        }
+    }
+    if( !BoomaChannelizer::IsOffsetSupported(frequency - _opts->GetFrequency(), _opts->GetOutputSampleRate(), _opts->GetChannelizerChannels()) ) {
+        HError("Channel receiver frequency %ld is outside the input spectrum", frequency);
+        return false;
+    }
+    _channelReceivers.push_back(new BoomaChannelReceiver(frequency, receiverModeType, outputFilename));
+    if( Reconfigure() ) {
+        return true;
+    }
+
+    // Do not leave a channel receiver behind that fails every later build
+    HError("Failed to add channel receiver for %ld, removing it again", frequency);
+    Halt();
+    ResetChannelReceivers();
+    delete _channelReceivers.back();
+    _channelReceivers.pop_back();
+    Reconfigure();
+    return false;
+}
+
+bool BoomaApplication::RemoveChannelReceiver(long int frequency) {
+    for( std::vector<BoomaChannelReceiver*>::iterator it = _channelReceivers.begin(); it != _channelReceivers.end(); it++ ) {
+        if( (*it)->GetFrequency() == frequency ) {
+            Halt();
+            ResetChannelReceivers();
+            delete (*it);
+            _channelReceivers.erase(it);
+            return Reconfigure();
+        }
+    }
+    return false;
+}
+
+std::vector<long int> BoomaApplication::GetChannelReceivers() {
+    std::vector<long int> frequencies;
+    for( std::vector<BoomaChannelReceiver*>::iterator it = _channelReceivers.begin(); it != _channelReceivers.end(); it++ ) {
+        frequencies.push_back((*it)->GetFrequency());
+    }
+    return frequencies;
+}
+
+int BoomaApplication::GetChannelReceiverSignalLevel(long int frequency) {
+    for( std::vector<BoomaChannelReceiver*>::iterator it = _channelReceivers.begin(); it != _channelReceivers.end(); it++ ) {
+        if( (*it)->GetFrequency() == frequency ) {
+            return (*it)->GetSignalLevel();
+        }
+    }
+    return 0;
+}
+
 bool BoomaApplication::SetInputFilterWidth(int width) {
     if( IsFaulty() ) {
         return false;
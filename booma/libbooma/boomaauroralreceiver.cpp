@@ -1,4 +1,5 @@
 #include "boomaauroralreceiver.h"
+#include "boomakaiserbesseldesigner.h"
 
 BoomaAuroralReceiver::BoomaAuroralReceiver(ConfigOptions* opts, int initialFrequency):
     BoomaReceiver(opts, initialFrequency),
@@ -50,11 +51,11 @@ HWriterConsumer<int16_t>* BoomaAuroralReceiver::PreProcess(ConfigOptions* opts,
 
     // Add a combfilter to kill (more) 50 hz harmonics
     HLog("Adding 50Hz humfilter for audio device input");
-    _humfilter = new HCombFilter<int16_t>("auroral_receiver_pre_process_hum_comb", previous, opts->GetInputSampleRate(), 50, -0.907f, BLOCKSIZE);
+    _humfilter = new HCombFilter<int16_t>("auroral_receiver_pre_process_hum_comb", Profile("auroral_receiver_pre_process_hum_comb", previous), opts->GetInputSampleRate(), 50, -0.907f, opts->GetBlocksize());
 
     // Narrow bandpass filter, from 100Hz to 10KHz.
     HLog("- Bandpass");
-    _bandpass = new HFirFilter<int16_t>("auroral_receiver_pre_process_bandpass_fir", _humfilter->Consumer(), HBandpassKaiserBessel<int16_t>(100, 10000, opts->GetOutputSampleRate(), 115, 96).Calculate(), 115, BLOCKSIZE);
+    _bandpass = new BoomaFirFilter("auroral_receiver_pre_process_bandpass_fir", Profile("auroral_receiver_pre_process_bandpass_fir", _humfilter->Consumer()), BoomaKaiserBesselDesigner::Bandpass(100, 10000, opts->GetOutputSampleRate(), 115, 96).data(), 115, opts->GetBlocksize(), false, opts->GetFastConvolutionThreshold());
 
     if( GetOption("Humfilter") == 1 ) {
         _humfilter->Enable();
@@ -75,8 +76,8 @@ HWriterConsumer<int16_t>* BoomaAuroralReceiver::Receive(ConfigOptions* opts, HWr
 HWriterConsumer<int16_t>* BoomaAuroralReceiver::PostProcess(ConfigOptions* opts, HWriterConsumer<int16_t>* previous) {
     HLog("Creating AURORAL receiver postprocessing chain");
 
-    _averaging = new HMovingAverageFilter<int16_t>("auroral_receiver_post_process_averaging", previous, 3, BLOCKSIZE);
-    _gaussian = new HGaussianFilter<int16_t>("auroral_receiver_post_process_gaussian", _averaging->Consumer(), BLOCKSIZE, 2, 1024);
+    _averaging = new HMovingAverageFilter<int16_t>("auroral_receiver_post_process_averaging", Profile("auroral_receiver_post_process_averaging", previous), 3, opts->GetBlocksize());
+    _gaussian = new HGaussianFilter<int16_t>("auroral_receiver_post_process_gaussian", Profile("auroral_receiver_post_process_gaussian", _averaging->Consumer()), opts->GetBlocksize(), 2, 1024);
 
     if( GetOption("MovingAveragefilter") == 1 ) {
         _averaging->Enable();
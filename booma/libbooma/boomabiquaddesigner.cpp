@@ -0,0 +1,70 @@
+#include <cmath>
+#include <complex>
+
+#include <hardtapi.h>
+
+#include "boomabiquaddesigner.h"
+
+std::map<BoomaBiQuadDesigner::Key, std::vector<float>> BoomaBiQuadDesigner::_cache;
+std::mutex BoomaBiQuadDesigner::_mutex;
+
+float* BoomaBiQuadDesigner::Bandpass(int rate, int center, int width, int sections, BoomaBiQuadPrototype prototype, float ripple) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    Key key = std::make_tuple(rate, center, width, sections, (int) prototype, prototype == CHEBYSHEV ? ripple : 0.0f);
+    std::map<Key, std::vector<float>>::iterator it = _cache.find(key);
+    if( it == _cache.end() ) {
+        HLog("Designing %d section %s bandpass, %dHz wide at %dHz with samplerate %d", sections, prototype == CHEBYSHEV ? "chebyshev" : "butterworth", width, center, rate);
+        it = _cache.insert(std::make_pair(key, Design(rate, center, width, sections, prototype, ripple))).first;
+    }
+    return it->second.data();
+}
+
+std::vector<float> BoomaBiQuadDesigner::Design(int rate, int center, int width, int sections, BoomaBiQuadPrototype prototype, float ripple) {
+
+    // Prewarped band edges
+    double low = tan(M_PI * (center - width / 2.0) / rate);
+    double high = tan(M_PI * (center + width / 2.0) / rate);
+    double w0 = sqrt(low * high);
+    double bw = high - low;
+
+    // Chebyshev poles are on an ellipse, butterworth poles on the unit circle
+    double sigma = 1;
+    double omega = 1;
+    if( prototype == CHEBYSHEV ) {
+        double mu = asinh(1 / sqrt(pow(10, ripple / 10) - 1)) / sections;
+        sigma = sinh(mu);
+        omega = cosh(mu);
+    }
+
+    // Transform each prototype pole to a pair of bandpass poles and keep the
+    // poles in the upper half plane, one per section
+    std::vector<std::complex<double>> poles;
+    for( int k = 1; k <= sections; k++ ) {
+        double theta = M_PI * (2 * k - 1) / (2 * sections);
+        std::complex<double> p(-sigma * sin(theta), omega * cos(theta));
+        std::complex<double> root = sqrt(p * bw * p * bw - 4 * w0 * w0);
+        for( int sign = -1; sign <= 1; sign += 2 ) {
+            std::complex<double> s = (p * bw + (double) sign * root) / 2.0;
+            std::complex<double> z = (1.0 + s) / (1.0 - s);
+            if( z.imag() > 0 ) {
+                poles.push_back(z);
+            }
+        }
+    }
+
+    // Each section has zeroes at z = 1 and z = -1, normalized to unity gain at the center
+    std::complex<double> e = std::polar(1.0, -2 * M_PI * center / rate);
+    std::vector<float> coefficients;
+    for( std::vector<std::complex<double>>::iterator it = poles.begin(); it != poles.end(); it++ ) {
+        double a1 = 2 * it->real();
+        double a2 = -std::norm(*it);
+        double gain = 1 / std::abs((1.0 - e * e) / (1.0 - a1 * e - a2 * e * e));
+        coefficients.push_back(gain);
+        coefficients.push_back(0);
+        coefficients.push_back(-gain);
+        coefficients.push_back(a1);
+        coefficients.push_back(a2);
+    }
+    return coefficients;
+}
@@ -0,0 +1,69 @@
+#include <algorithm>
+
+#include "boomablocktimer.h"
+
+BoomaBlockTimer::BoomaBlockTimer(std::string id, HReader<int16_t>* reader, size_t capacity):
+    HReader<int16_t>(id),
+    _reader(reader),
+    _capacity(capacity) {
+
+    _latencies.reserve(_capacity);
+    Reset();
+}
+
+void BoomaBlockTimer::Reset() {
+    _latencies.clear();
+    _next = 0;
+    _blocks = 0;
+    _samples = 0;
+    _maxLatency = 0;
+    _hasLastRead = false;
+}
+
+int BoomaBlockTimer::Read(int16_t* dest, size_t blocksize) {
+
+    // The time since the last read is the time spend processing the previous block
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if( _hasLastRead ) {
+        long latency = std::chrono::duration_cast<std::chrono::microseconds>(now - _lastRead).count();
+        if( _latencies.size() < _capacity ) {
+            _latencies.push_back(latency);
+        } else {
+            _latencies[_next] = latency;
+            _next = (_next + 1) % _capacity;
+        }
+        if( latency > _maxLatency ) {
+            _maxLatency = latency;
+        }
+    } else {
+        _firstRead = now;
+        _hasLastRead = true;
+    }
+    _lastRead = now;
+
+    // Read next block
+    int read = _reader->Read(dest, blocksize);
+    if( read > 0 ) {
+        _blocks++;
+        _samples += read;
+    }
+    return read;
+}
+
+double BoomaBlockTimer::GetElapsed() {
+    if( !_hasLastRead ) {
+        return 0;
+    }
+    return std::chrono::duration_cast<std::chrono::microseconds>(_lastRead - _firstRead).count() / 1000000.0;
+}
+
+long BoomaBlockTimer::GetLatencyPercentile(double percentile) {
+    if( _latencies.empty() ) {
+        return 0;
+    }
+
+    std::vector<long> sorted(_latencies);
+    size_t n = (size_t) ((percentile / 100) * (sorted.size() - 1));
+    std::nth_element(sorted.begin(), sorted.begin() + n, sorted.end());
+    return sorted[n];
+}
@@ -0,0 +1,191 @@
+#include <cmath>
+
+#include "boomacascadedbiquadfilter.h"
+#include "boomamemory.h"
+
+// Four float lanes and a matching lane mask, mapped to SSE or NEON by the compiler
+typedef float BoomaFloat4 __attribute__((vector_size(16)));
+typedef int32_t BoomaMask4 __attribute__((vector_size(16)));
+
+static inline BoomaFloat4 Load(const float* lanes) {
+    BoomaFloat4 v;
+    memcpy((void*) &v, (void*) lanes, sizeof(v));
+    return v;
+}
+
+static inline void Store(float* lanes, BoomaFloat4 v) {
+    memcpy((void*) lanes, (void*) &v, sizeof(v));
+}
+
+// Move lanes 0-2 up one lane and put 'x' in lane 0
+static inline BoomaFloat4 ShiftIn(BoomaFloat4 v, float x) {
+#if defined(__clang__)
+    v = __builtin_shufflevector(v, v, 0, 0, 1, 2);
+#else
+    v = __builtin_shuffle(v, (BoomaMask4) {0, 0, 1, 2});
+#endif
+    v[0] = x;
+    return v;
+}
+
+static inline BoomaFloat4 Select(BoomaMask4 mask, BoomaFloat4 a, BoomaFloat4 b) {
+    return (BoomaFloat4) (((BoomaMask4) a & mask) | ((BoomaMask4) b & ~mask));
+}
+
+BoomaCascadedBiQuadFilter::BoomaCascadedBiQuadFilter(std::string id, HWriterConsumer<int16_t>* consumer, float* coefficients, int length, size_t blocksize):
+    HFilter<int16_t>(id, consumer, blocksize) {
+
+    Init(coefficients, length, blocksize);
+}
+
+BoomaCascadedBiQuadFilter::BoomaCascadedBiQuadFilter(std::string id, HWriter<int16_t>* writer, float* coefficients, int length, size_t blocksize):
+    HFilter<int16_t>(id, writer, blocksize) {
+
+    Init(coefficients, length, blocksize);
+}
+
+BoomaCascadedBiQuadFilter::~BoomaCascadedBiQuadFilter() {
+    BoomaFree(_coefficients);
+    BoomaFree(_state);
+    BoomaFree(_buffer);
+    if( _next != nullptr ) {
+        BoomaFree(_next);
+    }
+}
+
+void BoomaCascadedBiQuadFilter::Init(float* coefficients, int length, size_t blocksize) {
+    _blocksize = blocksize;
+    _groups = 0;
+    _coefficients = nullptr;
+    _state = nullptr;
+    _buffer = BoomaAllocate<float>(blocksize);
+    _nextGroups = 0;
+    _next = nullptr;
+    _pending = false;
+
+    HLog("Creating cascaded biquad filter with %d sections", length / 5);
+    SetCoefficients(coefficients, length);
+    Apply();
+}
+
+void BoomaCascadedBiQuadFilter::SetCoefficients(float* coefficients, int length) {
+
+    // Transpose into lanes, unused lanes pass the samples through unchanged
+    int sections = length / 5;
+    int groups = (sections + 3) / 4;
+    float (*next)[5][4] = (float (*)[5][4]) BoomaAllocate<float>(groups * 5 * 4);
+    for( int section = 0; section < groups * 4; section++ ) {
+        for( int i = 0; i < 5; i++ ) {
+            next[section / 4][i][section % 4] = section < sections
+                ? coefficients[section * 5 + i]
+                : (i == 0 ? 1 : 0);
+        }
+    }
+
+    // Replace any coefficients that have not yet been picked up
+    std::lock_guard<std::mutex> lock(_mutex);
+    if( _next != nullptr ) {
+        BoomaFree(_next);
+    }
+    _next = next;
+    _nextGroups = groups;
+    _pending = true;
+}
+
+void BoomaCascadedBiQuadFilter::Apply() {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // Keep the filter history if the number of sections does not change
+    if( _nextGroups != _groups ) {
+        if( _state != nullptr ) {
+            BoomaFree(_state);
+        }
+        _state = (float (*)[4][4]) BoomaAllocate<float>(_nextGroups * 4 * 4);
+        memset((void*) _state, 0, sizeof(float) * _nextGroups * 4 * 4);
+        _groups = _nextGroups;
+    }
+
+    if( _coefficients != nullptr ) {
+        BoomaFree(_coefficients);
+    }
+    _coefficients = _next;
+    _next = nullptr;
+    _pending = false;
+}
+
+void BoomaCascadedBiQuadFilter::RunGroup(int group, float* samples) {
+
+    BoomaFloat4 b0 = Load(_coefficients[group][0]);
+    BoomaFloat4 b1 = Load(_coefficients[group][1]);
+    BoomaFloat4 b2 = Load(_coefficients[group][2]);
+    BoomaFloat4 a1 = Load(_coefficients[group][3]);
+    BoomaFloat4 a2 = Load(_coefficients[group][4]);
+    BoomaFloat4 x1 = Load(_state[group][0]);
+    BoomaFloat4 x2 = Load(_state[group][1]);
+    BoomaFloat4 y1 = Load(_state[group][2]);
+    BoomaFloat4 y2 = Load(_state[group][3]);
+    BoomaFloat4 out = {0, 0, 0, 0};
+
+    // At step k, lane n handles sample k - n, taking its input from the output of lane n - 1 in the previous step
+    int n = _blocksize;
+    for( int k = 0; k < n + 3; k++ ) {
+        BoomaFloat4 in = ShiftIn(out, k < n ? samples[k] : 0);
+        BoomaFloat4 y = b0 * in + b1 * x1 + b2 * x2 + a1 * y1 + a2 * y2;
+
+        if( k >= 3 && k < n ) {
+            x2 = x1;
+            x1 = in;
+            y2 = y1;
+            y1 = y;
+        } else {
+
+            // Filling or draining the pipeline, only lanes with a sample in this block may update their history
+            BoomaMask4 active = {
+                -(k < n),
+                -(k >= 1 && k - 1 < n),
+                -(k >= 2 && k - 2 < n),
+                -(k >= 3 && k - 3 < n)
+            };
+            x2 = Select(active, x1, x2);
+            x1 = Select(active, in, x1);
+            y2 = Select(active, y1, y2);
+            y1 = Select(active, y, y1);
+        }
+
+        out = y;
+        if( k >= 3 ) {
+            samples[k - 3] = y[3];
+        }
+    }
+
+    Store(_state[group][0], x1);
+    Store(_state[group][1], x2);
+    Store(_state[group][2], y1);
+    Store(_state[group][3], y2);
+}
+
+void BoomaCascadedBiQuadFilter::Filter(int16_t* src, int16_t* dest, size_t blocksize) {
+
+    if( blocksize != _blocksize ) {
+        HError("Requested blocksize %d differs from the filter blocksize %d", blocksize, _blocksize);
+        return;
+    }
+
+    // Pick up new coefficients
+    if( _pending ) {
+        Apply();
+    }
+
+    for( size_t i = 0; i < blocksize; i++ ) {
+        _buffer[i] = src[i];
+    }
+
+    for( int group = 0; group < _groups; group++ ) {
+        RunGroup(group, _buffer);
+    }
+
+    for( size_t i = 0; i < blocksize; i++ ) {
+        float value = _buffer[i];
+        dest[i] = value > 32767 ? 32767 : (value < -32768 ? -32768 : (int16_t) lrintf(value));
+    }
+}
@@ -0,0 +1,240 @@
+#include <cmath>
+
+#include "boomachannelizer.h"
+#include "boomamemory.h"
+#include "boomaconfigurationexception.h"
+
+BoomaChannelizerOutput::BoomaChannelizerOutput(size_t blocksize):
+    _writer(nullptr),
+    _channel(0),
+    _stepRe(1),
+    _stepIm(0),
+    _phaseRe(1),
+    _phaseIm(0),
+    _muted(false),
+    _nextChannel(0),
+    _nextStepRe(1),
+    _nextStepIm(0),
+    _nextMuted(false),
+    _update(false),
+    _blocksize(blocksize),
+    _length(0) {
+
+    _buffer = BoomaAllocate<int16_t>(_blocksize);
+}
+
+BoomaChannelizerOutput::~BoomaChannelizerOutput() {
+    BoomaFree(_buffer);
+}
+
+BoomaChannelizer::BoomaChannelizer(std::string id, HWriterConsumer<int16_t>* consumer, int rate, int channels, float* coefficients, int taps, size_t blocksize):
+    HWriter<int16_t>(id),
+    _rate(rate),
+    _channels(channels),
+    _decimation(channels / 2),
+    _taps(taps),
+    _blocksize(blocksize),
+    _outputs(0),
+    _pending(false) {
+
+    HLog("Creating channelizer with %d channels and %d taps at samplerate %d", _channels, _taps, _rate);
+
+    // The fft needs a power of 2 and the decimation must divide the number of IQ samples in a block
+    if( _channels < 4 || (_channels & (_channels - 1)) != 0 || ((_blocksize / 2) % _decimation) != 0 ) {
+        HError("Unsupported number of channels %d, must be a power of 2 and at least 4", _channels);
+        throw new BoomaConfigurationException("Unsupported number of channels for the channelizer");
+    }
+
+    // Scale the prototype filter to unity gain
+    float sum = 0;
+    for( int i = 0; i < _taps; i++ ) {
+        sum += coefficients[i];
+    }
+    _coefficients = BoomaAllocate<float>(_taps);
+    for( int i = 0; i < _taps; i++ ) {
+        _coefficients[i] = coefficients[i] / sum;
+    }
+
+    // Sample windows, 'taps - 1' samples of history followed by the new samples
+    _re = BoomaAllocate<float>((_taps - 1) + _blocksize / 2);
+    _im = BoomaAllocate<float>((_taps - 1) + _blocksize / 2);
+    memset((void*) _re, 0, sizeof(float) * ((_taps - 1) + _blocksize / 2));
+    memset((void*) _im, 0, sizeof(float) * ((_taps - 1) + _blocksize / 2));
+
+    _branchRe = BoomaAllocate<float>(_channels);
+    _branchIm = BoomaAllocate<float>(_channels);
+    _fft = new BoomaFft(_channels);
+
+    consumer->SetWriter(this);
+}
+
+BoomaChannelizer::~BoomaChannelizer() {
+    for( std::vector<BoomaChannelizerOutput*>::iterator it = _attached.begin(); it != _attached.end(); it++ ) {
+        delete (*it);
+    }
+    BoomaFree(_coefficients);
+    BoomaFree(_re);
+    BoomaFree(_im);
+    BoomaFree(_branchRe);
+    BoomaFree(_branchIm);
+    delete _fft;
+}
+
+BoomaChannelizerOutput* BoomaChannelizer::Attach(int offset) {
+    BoomaChannelizerOutput* output = new BoomaChannelizerOutput(_blocksize);
+    if( !SetOffset(output, offset) ) {
+        delete output;
+        throw new BoomaConfigurationException("Channel offset is outside the input spectrum");
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _attached.push_back(output);
+    _pending = true;
+    return output;
+}
+
+bool BoomaChannelizer::SetOffset(BoomaChannelizerOutput* output, int offset) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // Keep the output silent until it is moved back inside the input spectrum
+    if( !IsOffsetSupported(offset) ) {
+        HError("Channel offset %d is outside the input spectrum +/- %d, muting channel", offset, _rate / 2);
+        output->_nextMuted = true;
+        output->_update = true;
+        _pending = true;
+        return false;
+    }
+
+    // Nearest channel, then remove what is left with the output mixer
+    int channel = (int) lrint((double) offset / GetChannelSpacing());
+    double residual = offset - (double) channel * _rate / _channels;
+    output->_nextChannel = (channel + _channels) % _channels;
+    output->_nextStepRe = cos(-2 * M_PI * residual / GetChannelRate());
+    output->_nextStepIm = sin(-2 * M_PI * residual / GetChannelRate());
+    output->_nextMuted = false;
+    output->_update = true;
+    _pending = true;
+    HLog("Offset %d attached to channel %d with %fHz residual", offset, output->_nextChannel, residual);
+    return true;
+}
+
+void BoomaChannelizer::Apply() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for( std::vector<BoomaChannelizerOutput*>::iterator it = _attached.begin(); it != _attached.end(); it++ ) {
+        BoomaChannelizerOutput* output = (*it);
+        if( output->_update ) {
+            output->_channel = output->_nextChannel;
+            output->_stepRe = output->_nextStepRe;
+            output->_stepIm = output->_nextStepIm;
+            output->_muted = output->_nextMuted;
+            output->_update = false;
+        }
+    }
+    _pending = false;
+}
+
+int BoomaChannelizer::Write(int16_t* src, size_t blocksize) {
+
+    if( blocksize != _blocksize ) {
+        HError("Requested blocksize %d differs from the channelizer blocksize %d", blocksize, _blocksize);
+        return 0;
+    }
+
+    // Pick up moved or muted outputs
+    if( _pending ) {
+        Apply();
+    }
+
+    // Append the new samples after the history
+    int samples = blocksize / 2;
+    float* re = &_re[_taps - 1];
+    float* im = &_im[_taps - 1];
+    for( int i = 0; i < samples; i++ ) {
+        re[i] = src[2 * i];
+        im[i] = src[2 * i + 1];
+    }
+
+    for( int j = 0; j < samples; j += _decimation ) {
+
+        // Fold the filtered window into one sum per branch
+        for( int n = 0; n < _channels; n++ ) {
+            float sumRe = 0;
+            float sumIm = 0;
+            for( int i = n; i < _taps; i += _channels ) {
+                sumRe += _coefficients[i] * re[j - i];
+                sumIm += _coefficients[i] * im[j - i];
+            }
+            _branchRe[n] = sumRe;
+            _branchIm[n] = sumIm;
+        }
+
+        // Channel k is the k'th bin of the inverse fft. Since we only keep every
+        // N/2 sample, the remaining downconversion is a sign change of odd
+        // channels for every second output
+        _fft->Inverse(_branchRe, _branchIm);
+        bool flip = (_outputs++ & 1) != 0;
+
+        for( std::vector<BoomaChannelizerOutput*>::iterator it = _attached.begin(); it != _attached.end(); it++ ) {
+            BoomaChannelizerOutput* output = (*it);
+            float yRe = _branchRe[output->_channel];
+            float yIm = _branchIm[output->_channel];
+            if( flip && (output->_channel & 1) ) {
+                yRe = -yRe;
+                yIm = -yIm;
+            }
+
+            float outRe = output->_muted ? 0 : yRe * output->_phaseRe - yIm * output->_phaseIm;
+            float outIm = output->_muted ? 0 : yRe * output->_phaseIm + yIm * output->_phaseRe;
+            double phaseRe = output->_phaseRe * output->_stepRe - output->_phaseIm * output->_stepIm;
+            output->_phaseIm = output->_phaseRe * output->_stepIm + output->_phaseIm * output->_stepRe;
+            output->_phaseRe = phaseRe;
+
+            output->_buffer[output->_length++] = outRe > 32767 ? 32767 : (outRe < -32768 ? -32768 : (int16_t) lrintf(outRe));
+            output->_buffer[output->_length++] = outIm > 32767 ? 32767 : (outIm < -32768 ? -32768 : (int16_t) lrintf(outIm));
+
+            // Pass on full blocks, and keep the mixer phase from drifting in amplitude
+            if( output->_length == output->_blocksize ) {
+                if( output->_writer != nullptr ) {
+                    output->_writer->Write(output->_buffer, output->_blocksize);
+                }
+                output->_length = 0;
+
+                double magnitude = sqrt(output->_phaseRe * output->_phaseRe + output->_phaseIm * output->_phaseIm);
+                output->_phaseRe /= magnitude;
+                output->_phaseIm /= magnitude;
+            }
+        }
+    }
+
+    // Keep the last 'taps - 1' samples as history for the next block
+    memmove((void*) _re, (void*) &_re[samples], sizeof(float) * (_taps - 1));
+    memmove((void*) _im, (void*) &_im[samples], sizeof(float) * (_taps - 1));
+
+    return blocksize;
+}
+
+bool BoomaChannelizer::Start() {
+    bool result = true;
+    for( std::vector<BoomaChannelizerOutput*>::iterator it = _attached.begin(); it != _attached.end(); it++ ) {
+        if( (*it)->_writer != nullptr ) {
+            result = (*it)->_writer->Start() && result;
+        }
+    }
+    return result;
+}
+
+bool BoomaChannelizer::Stop() {
+    bool result = true;
+    for( std::vector<BoomaChannelizerOutput*>::iterator it = _attached.begin(); it != _attached.end(); it++ ) {
+        if( (*it)->_writer != nullptr ) {
+            result = (*it)->_writer->Stop() && result;
+        }
+    }
+    return result;
+}
+
+bool BoomaChannelizer::Command(HCommand* command) {
+
+    // Commands are meant for the main receiver chain, the channel receivers are tuned by the channelizer
+    return true;
+}
@@ -0,0 +1,71 @@
+#include "boomachannelreceiver.h"
+#include "boomacwreceiver.h"
+#include "boomaamreceiver.h"
+#include "boomaauroralreceiver.h"
+#include "boomassbreceiver.h"
+
+BoomaChannelReceiver::BoomaChannelReceiver(long int frequency, ReceiverModeType receiverModeType, std::string outputFilename):
+    _frequency(frequency),
+    _receiverModeType(receiverModeType),
+    _outputFilename(outputFilename),
+    _opts(nullptr),
+    _channel(nullptr),
+    _receiver(nullptr),
+    _output(nullptr) {}
+
+BoomaChannelReceiver::~BoomaChannelReceiver() {
+    Reset();
+}
+
+void BoomaChannelReceiver::Reset() {
+    SAFE_DELETE(_output);
+    SAFE_DELETE(_receiver);
+    SAFE_DELETE(_opts);
+    _channel = nullptr;
+}
+
+void BoomaChannelReceiver::Build(ConfigOptions* opts, BoomaChannelizer* channelizer) {
+    HLog("Building channel receiver for %ld", _frequency);
+
+    // Channel receivers run at the channel samplerate and never dump or play on the soundcard
+    _opts = new ConfigOptions(opts);
+    _opts->SetOutputSampleRate(channelizer->GetChannelRate());
+    _opts->SetReceiverModeType(_receiverModeType);
+    _opts->SetFrequency(_frequency);
+    _opts->SetOutputFilename(_outputFilename);
+    _opts->SetOutputAudioDevice(-1);
+    _opts->SetDumpRf(false);
+    _opts->SetDumpAudio(false);
+
+    // The channel is delivered with the frequency at 0Hz
+    _channel = channelizer->Attach(_frequency - opts->GetFrequency());
+    switch( _receiverModeType ) {
+        case CW:
+            _receiver = new BoomaCwReceiver(_opts, 0);
+            break;
+        case AM:
+            _receiver = new BoomaAmReceiver(_opts, 0);
+            break;
+        case AURORAL:
+            _receiver = new BoomaAuroralReceiver(_opts, 0);
+            break;
+        case SSB:
+            _receiver = new BoomaSsbReceiver(_opts, 0);
+            break;
+        default:
+            throw new BoomaConfigurationException("Unknown receiver type for channel receiver");
+    }
+    _receiver->Build(_opts, _channel);
+    _output = new BoomaOutput(_opts, _receiver);
+}
+
+bool BoomaChannelReceiver::SetFrequency(ConfigOptions* opts, BoomaChannelizer* channelizer) {
+    if( _channel == nullptr ) {
+        return false;
+    }
+    if( !channelizer->SetOffset(_channel, _frequency - opts->GetFrequency()) ) {
+        HError("Channel receiver for %ld is outside the input spectrum, muted until tuned back", _frequency);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,89 @@
+#include <cmath>
+
+#include "boomaciccompensation.h"
+
+BoomaCicCompensation::BoomaCicCompensation(int factor, int stages, int cutoff, int rate, int taps, float attenuation):
+    _factor(factor),
+    _stages(stages),
+    _cutoff(cutoff),
+    _rate(rate),
+    _taps(taps),
+    _attenuation(attenuation) {}
+
+double BoomaCicCompensation::CicResponse(double frequency) {
+    if( frequency == 0 ) {
+        return 1;
+    }
+
+    // Normalized CIC response, frequency relative to the CIC output rate
+    double x = M_PI * frequency / _rate;
+    return pow(fabs(sin(x) / (_factor * sin(x / _factor))), _stages);
+}
+
+double BoomaCicCompensation::Bessel(double x) {
+
+    // Zeroth order modified Bessel function of the first kind
+    double sum = 1;
+    double term = 1;
+    for( int k = 1; k < 50; k++ ) {
+        term *= (x / (2 * k)) * (x / (2 * k));
+        sum += term;
+        if( term < sum * 1e-12 ) {
+            break;
+        }
+    }
+    return sum;
+}
+
+int BoomaCicCompensation::GetTaps(int rate, int passband, int stopband, float attenuation) {
+    int taps = (int) ceil((attenuation - 7.95) / (14.36 * (stopband - passband) / rate)) + 1;
+    return taps % 2 == 0 ? taps + 1 : taps;
+}
+
+float* BoomaCicCompensation::Calculate() {
+
+    // A single tap can only be a passthrough
+    if( _taps <= 1 ) {
+        float* coefficients = new float[1];
+        coefficients[0] = 1;
+        return coefficients;
+    }
+
+    // Kaiser window beta for the requested stopband attenuation
+    double beta;
+    if( _attenuation > 50 ) {
+        beta = 0.1102 * (_attenuation - 8.7);
+    } else if( _attenuation >= 21 ) {
+        beta = 0.5842 * pow(_attenuation - 21, 0.4) + 0.07886 * (_attenuation - 21);
+    } else {
+        beta = 0;
+    }
+
+    // Ideal response is the inverse CIC response up to the cutoff and zero above,
+    // get the impulse response by integrating over the passband
+    const int steps = 2048;
+    double step = (double) _cutoff / steps;
+    double center = (_taps - 1) / 2.0;
+    double* h = new double[_taps];
+    double sum = 0;
+    for( int n = 0; n < _taps; n++ ) {
+        double value = 0;
+        for( int i = 0; i < steps; i++ ) {
+            double f = (i + 0.5) * step;
+            value += cos(2 * M_PI * f * (n - center) / _rate) / CicResponse(f);
+        }
+        value *= 2 * step / _rate;
+
+        double r = (n - center) / center;
+        h[n] = value * Bessel(beta * sqrt(1 - r * r)) / Bessel(beta);
+        sum += h[n];
+    }
+
+    // Unity gain at DC
+    float* coefficients = new float[_taps];
+    for( int n = 0; n < _taps; n++ ) {
+        coefficients[n] = h[n] / sum;
+    }
+    delete[] h;
+    return coefficients;
+}
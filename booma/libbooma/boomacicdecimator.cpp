@@ -0,0 +1,120 @@
+#include <cmath>
+
+#include "boomacicdecimator.h"
+#include "boomamemory.h"
+
+BoomaCicDecimator::BoomaCicDecimator(std::string id, HReader<int16_t>* reader, int factor, int stages, size_t blocksize, bool isIq):
+    HReader<int16_t>(id),
+    _reader(reader),
+    _factor(factor),
+    _stages(stages),
+    _blocksize(blocksize),
+    _channels(isIq ? 2 : 1) {
+
+    HLog("Creating CIC decimator with factor %d and %d stages for %s samples", _factor, _stages, isIq ? "IQ" : "real");
+    if( GetRegisterBits(_factor, _stages) > 64 ) {
+        HError("CIC decimator needs %d bit registers, output will be corrupted", GetRegisterBits(_factor, _stages));
+    }
+
+    _scale = 1.0 / pow((double) _factor, _stages);
+    _input = BoomaAllocate<int16_t>(_factor * _blocksize);
+
+    _integrators = new uint64_t*[_channels];
+    _combs = new uint64_t*[_channels];
+    for( int ch = 0; ch < _channels; ch++ ) {
+        _integrators[ch] = BoomaAllocate<uint64_t>(_stages);
+        _combs[ch] = BoomaAllocate<uint64_t>(_stages);
+        memset((void*) _integrators[ch], 0, sizeof(uint64_t) * _stages);
+        memset((void*) _combs[ch], 0, sizeof(uint64_t) * _stages);
+    }
+}
+
+BoomaCicDecimator::~BoomaCicDecimator() {
+    BoomaFree(_input);
+    for( int ch = 0; ch < _channels; ch++ ) {
+        BoomaFree(_integrators[ch]);
+        BoomaFree(_combs[ch]);
+    }
+    delete[] _integrators;
+    delete[] _combs;
+}
+
+int BoomaCicDecimator::GetRegisterBits(int factor, int stages) {
+    return 16 + (int) ceil(stages * log2((double) factor));
+}
+
+int BoomaCicDecimator::GetStages(int factor, double edge, float attenuation) {
+
+    // The worst alias is the image of the passband edge around the first null
+    double wanted = fabs(sin(M_PI * edge) / (factor * sin(M_PI * edge / factor)));
+    double image = fabs(sin(M_PI * (1 - edge)) / (factor * sin(M_PI * (1 - edge) / factor)));
+    return (int) ceil(attenuation / (20 * log10(wanted / image)));
+}
+
+int BoomaCicDecimator::GetFinalFactor(int factor) {
+
+    // Prefer the highest divisor from 8 and down to 4
+    for( int final = 8; final >= 4; final-- ) {
+        if( factor % final == 0 ) {
+            return final;
+        }
+    }
+
+    // Otherwise the lowest divisor above 8, or the full factor
+    for( int final = 9; final < factor; final++ ) {
+        if( factor % final == 0 ) {
+            return final;
+        }
+    }
+    return factor;
+}
+
+int BoomaCicDecimator::Read(int16_t* dest, size_t blocksize) {
+
+    if( blocksize != _blocksize ) {
+        HError("Requested blocksize %d differs from the decimator blocksize %d", blocksize, _blocksize);
+        return 0;
+    }
+
+    // Get 'factor' blocks from upstream
+    for( int block = 0; block < _factor; block++ ) {
+        int read = _reader->Read(&_input[block * _blocksize], _blocksize);
+        if( read != (int) _blocksize ) {
+            HLog("Upstream reader returned %d, expected %d", read, _blocksize);
+            return 0;
+        }
+    }
+
+    // Run each channel through the integrators at the input rate, and the
+    // combs at the output rate. Wrap-around in the integrators cancels out
+    // in the combs as long as the registers are wide enough
+    int outputs = _blocksize / _channels;
+    for( int ch = 0; ch < _channels; ch++ ) {
+        uint64_t* integrators = _integrators[ch];
+        uint64_t* combs = _combs[ch];
+        int16_t* src = &_input[ch];
+
+        for( int n = 0; n < outputs; n++ ) {
+            for( int i = 0; i < _factor; i++ ) {
+                uint64_t value = (uint64_t) (int64_t) *src;
+                src += _channels;
+                for( int s = 0; s < _stages; s++ ) {
+                    integrators[s] += value;
+                    value = integrators[s];
+                }
+            }
+
+            uint64_t value = integrators[_stages - 1];
+            for( int s = 0; s < _stages; s++ ) {
+                uint64_t delayed = combs[s];
+                combs[s] = value;
+                value -= delayed;
+            }
+
+            double scaled = (double) (int64_t) value * _scale;
+            dest[n * _channels + ch] = scaled > 32767 ? 32767 : (scaled < -32768 ? -32768 : (int16_t) lrint(scaled));
+        }
+    }
+
+    return blocksize;
+}
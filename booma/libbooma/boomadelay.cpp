@@ -0,0 +1,65 @@
+#include "boomadelay.h"
+
+BoomaDelay::BoomaDelay(std::string id, HWriterConsumer<int16_t>* consumer, size_t blocksize, int rate, int seconds):
+    HWriter<int16_t>(id),
+    _writer(nullptr) {
+
+    Init(blocksize, rate, seconds);
+    consumer->SetWriter(this);
+}
+
+BoomaDelay::BoomaDelay(std::string id, BoomaSplitter* splitter, size_t blocksize, int rate, int seconds):
+    HWriter<int16_t>(id),
+    _writer(nullptr) {
+
+    Init(blocksize, rate, seconds);
+    splitter->SetBlockWriter(this);
+}
+
+BoomaDelay::~BoomaDelay() {
+    for( int i = 0; i < _length; i++ ) {
+        _blocks[i]->Release();
+    }
+    delete[] _blocks;
+}
+
+void BoomaDelay::Init(size_t blocksize, int rate, int seconds) {
+    _pool = BoomaBlockPool<int16_t>::Get(blocksize);
+    _length = ((long) rate * seconds) / blocksize;
+    if( _length < 1 ) {
+        _length = 1;
+    }
+    _position = 0;
+    HLog("Creating delay of %d blocks", _length);
+
+    // All slots start out referencing the same block of silence
+    BoomaBlock<int16_t>* silence = _pool->Acquire();
+    memset((void*) silence->GetData(), 0, sizeof(int16_t) * blocksize);
+    _blocks = new BoomaBlock<int16_t>*[_length];
+    for( int i = 0; i < _length; i++ ) {
+        if( i > 0 ) {
+            silence->AddRef();
+        }
+        _blocks[i] = silence;
+    }
+}
+
+int BoomaDelay::Write(int16_t* src, size_t blocksize) {
+    BoomaBlock<int16_t>* block = _pool->Copy(src, blocksize);
+    int written = WriteBlock(block);
+    block->Release();
+    return written;
+}
+
+int BoomaDelay::WriteBlock(BoomaBlock<int16_t>* block) {
+
+    // Swap in the new block and pass on the oldest
+    block->AddRef();
+    BoomaBlock<int16_t>* oldest = _blocks[_position];
+    _blocks[_position] = block;
+    _position = (_position + 1) % _length;
+
+    _writer->Write(oldest->GetData(), oldest->GetLength());
+    oldest->Release();
+    return block->GetLength();
+}
@@ -0,0 +1,37 @@
+#include "boomademandgate.h"
+
+BoomaDemandGate::BoomaDemandGate(std::string id, HWriterConsumer<int16_t>* consumer, int timeout):
+    HWriter<int16_t>(id),
+    _name(id),
+    _writer(nullptr),
+    _timeout(timeout),
+    _lastPoll(0),
+    _isOpen(false) {
+
+    HLog("Creating demand gate %s with timeout %d ms", id.c_str(), timeout);
+    consumer->SetWriter(this);
+}
+
+long long BoomaDemandGate::Now() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void BoomaDemandGate::Poll() {
+    _lastPoll = Now();
+}
+
+bool BoomaDemandGate::IsOpen() {
+    return _timeout == 0 || Now() - _lastPoll < _timeout;
+}
+
+int BoomaDemandGate::Write(int16_t* src, size_t blocksize) {
+
+    // Report changes so that it is visible in the log when a branch is bypassed
+    bool isOpen = IsOpen();
+    if( isOpen != _isOpen ) {
+        HLog("Demand gate %s %s", _name.c_str(), isOpen ? "opened" : "closed");
+        _isOpen = isOpen;
+    }
+
+    return isOpen ? _writer->Write(src, blocksize) : blocksize;
+}
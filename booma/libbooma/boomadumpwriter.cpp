@@ -0,0 +1,241 @@
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "boomadumpwriter.h"
+
+// Preallocate file space in steps of this size
+#define DUMP_PREALLOCATION (16 * 1024 * 1024)
+
+// Size of the (canonical, 16 bit pcm) wav header
+#define WAV_HEADER_SIZE 44
+
+BoomaDumpWriter::BoomaDumpWriter(std::string id, std::string filename, bool isWav, HWriterConsumer<int16_t>* consumer, int rate, int channels, size_t blocksize, int blocks, int rotateMegabytes, int rotateSeconds):
+    HWriter<int16_t>(id),
+    _filename(filename),
+    _extension(isWav ? ".wav" : ".pcm"),
+    _isWav(isWav),
+    _rate(rate),
+    _channels(channels),
+    _rotateBytes((unsigned long) rotateMegabytes * 1024 * 1024),
+    _rotateSeconds(rotateSeconds),
+    _thread(nullptr),
+    _running(false),
+    _dropped(0),
+    _fd(-1),
+    _sequence(0),
+    _bytes(0),
+    _allocated(0) {
+
+    Init(blocksize, blocks);
+    consumer->SetWriter(this);
+}
+
+BoomaDumpWriter::BoomaDumpWriter(std::string id, std::string filename, std::string extension, int rate, int channels, size_t blocksize, int blocks):
+    HWriter<int16_t>(id),
+    _filename(filename),
+    _extension(extension),
+    _isWav(false),
+    _rate(rate),
+    _channels(channels),
+    _rotateBytes(0),
+    _rotateSeconds(0),
+    _thread(nullptr),
+    _running(false),
+    _dropped(0),
+    _fd(-1),
+    _sequence(0),
+    _bytes(0),
+    _allocated(0) {
+
+    Init(blocksize, blocks);
+}
+
+void BoomaDumpWriter::Init(size_t blocksize, int blocks) {
+    HLog("Creating dump writer with %d blocks of %d samples", blocks, blocksize);
+    _ring = new BoomaBlockRing<int16_t>(blocks, blocksize);
+}
+
+BoomaDumpWriter::~BoomaDumpWriter() {
+    Stop();
+    delete _ring;
+}
+
+bool BoomaDumpWriter::Start() {
+    if( _thread != nullptr ) {
+        return true;
+    }
+    _running = true;
+    _thread = new std::thread( [this]() { Consume(); } );
+    return true;
+}
+
+bool BoomaDumpWriter::Stop() {
+    if( _thread == nullptr ) {
+        return true;
+    }
+
+    // The I/O thread drains the ring before it ends
+    _running = false;
+    _thread->join();
+    delete _thread;
+    _thread = nullptr;
+
+    if( _dropped > 0 ) {
+        HError("Dump writer dropped %lu blocks since the disk could not keep up", (unsigned long) _dropped);
+    }
+    return true;
+}
+
+int BoomaDumpWriter::Write(int16_t* src, size_t blocksize) {
+    if( blocksize > _ring->GetBlocksize() ) {
+        HError("Requested blocksize %d is larger than the ring blocksize %d", blocksize, _ring->GetBlocksize());
+        return 0;
+    }
+    Queue(src, blocksize);
+    return blocksize;
+}
+
+bool BoomaDumpWriter::Queue(int16_t* src, size_t blocksize) {
+
+    // Make sure we are running, the writer may not have been started
+    if( _thread == nullptr && !Start() ) {
+        return false;
+    }
+
+    // Never wait for the disk, drop the block if the ring is full
+    int16_t* block = blocksize <= _ring->GetBlocksize() ? _ring->WriteBlock() : nullptr;
+    if( block == nullptr ) {
+        _dropped++;
+        return false;
+    }
+    memcpy((void*) block, (void*) src, blocksize * sizeof(int16_t));
+    _ring->Commit(blocksize);
+    return true;
+}
+
+void BoomaDumpWriter::Consume() {
+    HLog("Dump writer is running");
+    while( true ) {
+        int length;
+        int16_t* block = _ring->ReadBlock(&length);
+        if( block == nullptr ) {
+            if( !_running ) {
+                break;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            continue;
+        }
+        Append(block, length);
+        _ring->Release();
+    }
+    Close();
+    HLog("Dump writer has stopped");
+}
+
+void BoomaDumpWriter::Append(int16_t* block, int length) {
+    unsigned long size = length * sizeof(int16_t);
+
+    // Rotate when the current file is full
+    if( _fd >= 0 ) {
+        unsigned long data = _bytes - (_isWav ? WAV_HEADER_SIZE : 0);
+        if( (_rotateBytes > 0 && _bytes + size > _rotateBytes) ||
+            (_rotateSeconds > 0 && data / (sizeof(int16_t) * _channels * _rate) >= _rotateSeconds) ) {
+            Close();
+        }
+    }
+    if( _fd < 0 && !Open() ) {
+        _dropped++;
+        return;
+    }
+
+    // Keep ahead of the writes, allocating without changing the file size
+    if( _bytes + size > _allocated ) {
+        unsigned long step = _rotateBytes > 0 && _rotateBytes < DUMP_PREALLOCATION ? _rotateBytes : DUMP_PREALLOCATION;
+        if( fallocate(_fd, FALLOC_FL_KEEP_SIZE, _allocated, step) == 0 ) {
+            _allocated += step;
+        } else {
+            _allocated = _bytes + size;
+        }
+    }
+
+    if( write(_fd, (void*) block, size) != (ssize_t) size ) {
+        HError("Dump writer failed to write a block, dropping it");
+        _dropped++;
+        return;
+    }
+    _bytes += size;
+}
+
+bool BoomaDumpWriter::Open() {
+    std::string name = _filename;
+    if( _rotateBytes > 0 || _rotateSeconds > 0 ) {
+        char sequence[8];
+        snprintf(sequence, sizeof(sequence), "_%03d", ++_sequence);
+        name += sequence;
+    }
+    name += _extension;
+
+    HLog("Opening dump file %s", name.c_str());
+    _fd = open(name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if( _fd < 0 ) {
+        HError("Unable to open dump file %s", name.c_str());
+        return false;
+    }
+    _bytes = 0;
+    _allocated = 0;
+
+    // Sizes in the wav header are set when the file is closed
+    if( _isWav ) {
+        char header[WAV_HEADER_SIZE] = {0};
+        uint32_t u;
+        uint16_t w;
+        memcpy(header, "RIFF", 4);
+        memcpy(header + 8, "WAVEfmt ", 8);
+        u = 16;
+        memcpy(header + 16, &u, 4);
+        w = 1;
+        memcpy(header + 20, &w, 2);
+        w = _channels;
+        memcpy(header + 22, &w, 2);
+        u = _rate;
+        memcpy(header + 24, &u, 4);
+        u = _rate * _channels * sizeof(int16_t);
+        memcpy(header + 28, &u, 4);
+        w = _channels * sizeof(int16_t);
+        memcpy(header + 32, &w, 2);
+        w = 16;
+        memcpy(header + 34, &w, 2);
+        memcpy(header + 36, "data", 4);
+        if( write(_fd, header, WAV_HEADER_SIZE) != WAV_HEADER_SIZE ) {
+            HError("Unable to write wav header to %s", name.c_str());
+            close(_fd);
+            _fd = -1;
+            return false;
+        }
+        _bytes = WAV_HEADER_SIZE;
+    }
+    return true;
+}
+
+void BoomaDumpWriter::Close() {
+    if( _fd < 0 ) {
+        return;
+    }
+    if( _isWav ) {
+        uint32_t riff = _bytes - 8;
+        uint32_t data = _bytes - WAV_HEADER_SIZE;
+        if( pwrite(_fd, &riff, 4, 4) != 4 || pwrite(_fd, &data, 4, 40) != 4 ) {
+            HError("Unable to update wav header in dump file");
+        }
+    }
+
+    // Release preallocated space that was not used
+    if( ftruncate(_fd, _bytes) != 0 ) {
+        HError("Unable to trim dump file");
+    }
+    close(_fd);
+    _fd = -1;
+}
@@ -0,0 +1,93 @@
+#include <cmath>
+#include <utility>
+
+#include "boomafft.h"
+#include "boomamemory.h"
+
+BoomaFft::BoomaFft(int size):
+    _size(size) {
+
+    int bits = 0;
+    while( (1 << bits) < _size ) {
+        bits++;
+    }
+
+    _reversed = BoomaAllocate<int>(_size);
+    for( int i = 0; i < _size; i++ ) {
+        int r = 0;
+        for( int b = 0; b < bits; b++ ) {
+            r |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        _reversed[i] = r;
+    }
+
+    // Twiddles for each stage are stored after each other, stage with 'half'
+    // butterflies starts at index 'half - 1'
+    _twiddlesRe = BoomaAllocate<float>(_size);
+    _twiddlesIm = BoomaAllocate<float>(_size);
+    for( int half = 1; half < _size; half <<= 1 ) {
+        for( int k = 0; k < half; k++ ) {
+            _twiddlesRe[half - 1 + k] = cos(-M_PI * k / half);
+            _twiddlesIm[half - 1 + k] = sin(-M_PI * k / half);
+        }
+    }
+}
+
+BoomaFft::~BoomaFft() {
+    BoomaFree(_reversed);
+    BoomaFree(_twiddlesRe);
+    BoomaFree(_twiddlesIm);
+}
+
+void BoomaFft::Forward(float* re, float* im) {
+
+    for( int i = 0; i < _size; i++ ) {
+        if( i < _reversed[i] ) {
+            std::swap(re[i], re[_reversed[i]]);
+            std::swap(im[i], im[_reversed[i]]);
+        }
+    }
+
+    // First two stages as one radix-4 pass, the twiddles are 1 and -j so no multiplications are needed
+    int half = 1;
+    if( _size >= 4 ) {
+        for( int start = 0; start < _size; start += 4 ) {
+            float ar = re[start] + re[start + 1];
+            float ai = im[start] + im[start + 1];
+            float br = re[start] - re[start + 1];
+            float bi = im[start] - im[start + 1];
+            float cr = re[start + 2] + re[start + 3];
+            float ci = im[start + 2] + im[start + 3];
+            float dr = re[start + 2] - re[start + 3];
+            float di = im[start + 2] - im[start + 3];
+            re[start] = ar + cr;
+            im[start] = ai + ci;
+            re[start + 2] = ar - cr;
+            im[start + 2] = ai - ci;
+            re[start + 1] = br + di;
+            im[start + 1] = bi - dr;
+            re[start + 3] = br - di;
+            im[start + 3] = bi + dr;
+        }
+        half = 4;
+    }
+
+    for( ; half < _size; half <<= 1 ) {
+        float* wr = &_twiddlesRe[half - 1];
+        float* wi = &_twiddlesIm[half - 1];
+        for( int start = 0; start < _size; start += 2 * half ) {
+            float* ar = &re[start];
+            float* ai = &im[start];
+            float* br = &re[start + half];
+            float* bi = &im[start + half];
+            for( int k = 0; k < half; k++ ) {
+                float tr = br[k] * wr[k] - bi[k] * wi[k];
+                float ti = br[k] * wi[k] + bi[k] * wr[k];
+                br[k] = ar[k] - tr;
+                bi[k] = ai[k] - ti;
+                ar[k] = ar[k] + tr;
+                ai[k] = ai[k] + ti;
+            }
+        }
+    }
+}
@@ -0,0 +1,397 @@
+#include <cmath>
+#include <utility>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BOOMA_FIR_X86
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define BOOMA_FIR_NEON
+#endif
+
+#include "boomafirfilter.h"
+#include "boomamemory.h"
+
+// Kernels, 'length' is always a multiple of 16
+
+static int32_t DotScalar(const int16_t* coefficients, const int16_t* samples, int length) {
+    int32_t acc = 0;
+    for( int i = 0; i < length; i++ ) {
+        acc += (int32_t) coefficients[i] * samples[i];
+    }
+    return acc;
+}
+
+#ifdef BOOMA_FIR_X86
+__attribute__((target("sse2")))
+static int32_t DotSse2(const int16_t* coefficients, const int16_t* samples, int length) {
+    __m128i acc0 = _mm_setzero_si128();
+    __m128i acc1 = _mm_setzero_si128();
+    for( int i = 0; i < length; i += 16 ) {
+        acc0 = _mm_add_epi32(acc0, _mm_madd_epi16(_mm_loadu_si128((const __m128i*) &coefficients[i]), _mm_loadu_si128((const __m128i*) &samples[i])));
+        acc1 = _mm_add_epi32(acc1, _mm_madd_epi16(_mm_loadu_si128((const __m128i*) &coefficients[i + 8]), _mm_loadu_si128((const __m128i*) &samples[i + 8])));
+    }
+    __m128i acc = _mm_add_epi32(acc0, acc1);
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(acc);
+}
+
+__attribute__((target("avx2")))
+static int32_t DotAvx2(const int16_t* coefficients, const int16_t* samples, int length) {
+    __m256i acc = _mm256_setzero_si256();
+    for( int i = 0; i < length; i += 16 ) {
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(_mm256_loadu_si256((const __m256i*) &coefficients[i]), _mm256_loadu_si256((const __m256i*) &samples[i])));
+    }
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+}
+#endif
+
+#ifdef BOOMA_FIR_NEON
+static int32_t DotNeon(const int16_t* coefficients, const int16_t* samples, int length) {
+    int32x4_t acc0 = vdupq_n_s32(0);
+    int32x4_t acc1 = vdupq_n_s32(0);
+    for( int i = 0; i < length; i += 16 ) {
+        int16x8_t c0 = vld1q_s16(&coefficients[i]);
+        int16x8_t c1 = vld1q_s16(&coefficients[i + 8]);
+        int16x8_t s0 = vld1q_s16(&samples[i]);
+        int16x8_t s1 = vld1q_s16(&samples[i + 8]);
+        acc0 = vmlal_s16(acc0, vget_low_s16(c0), vget_low_s16(s0));
+        acc1 = vmlal_s16(acc1, vget_high_s16(c0), vget_high_s16(s0));
+        acc0 = vmlal_s16(acc0, vget_low_s16(c1), vget_low_s16(s1));
+        acc1 = vmlal_s16(acc1, vget_high_s16(c1), vget_high_s16(s1));
+    }
+    int32x4_t acc = vaddq_s32(acc0, acc1);
+    int32x2_t sum = vadd_s32(vget_low_s32(acc), vget_high_s32(acc));
+    return vget_lane_s32(vpadd_s32(sum, sum), 0);
+}
+#endif
+
+bool BoomaFirFilter::IsSupported(BoomaFirKernel kernel) {
+    switch( kernel ) {
+        case FIR_KERNEL_AUTO:
+        case FIR_KERNEL_SCALAR:
+            return true;
+#ifdef BOOMA_FIR_X86
+        case FIR_KERNEL_SSE2:
+            return __builtin_cpu_supports("sse2");
+        case FIR_KERNEL_AVX2:
+            return __builtin_cpu_supports("avx2");
+#endif
+#ifdef BOOMA_FIR_NEON
+        case FIR_KERNEL_NEON:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+BoomaFirKernel BoomaFirFilter::GetBestKernel() {
+    if( IsSupported(FIR_KERNEL_AVX2) ) {
+        return FIR_KERNEL_AVX2;
+    }
+    if( IsSupported(FIR_KERNEL_SSE2) ) {
+        return FIR_KERNEL_SSE2;
+    }
+    if( IsSupported(FIR_KERNEL_NEON) ) {
+        return FIR_KERNEL_NEON;
+    }
+    return FIR_KERNEL_SCALAR;
+}
+
+const char* BoomaFirFilter::GetKernelName(BoomaFirKernel kernel) {
+    switch( kernel ) {
+        case FIR_KERNEL_AUTO: return "auto";
+        case FIR_KERNEL_SCALAR: return "scalar";
+        case FIR_KERNEL_SSE2: return "sse2";
+        case FIR_KERNEL_AVX2: return "avx2";
+        case FIR_KERNEL_NEON: return "neon";
+        default: return "unknown";
+    }
+}
+
+BoomaFirFilter::BoomaFirFilter(std::string id, HWriterConsumer<int16_t>* consumer, float* coefficients, int taps, size_t blocksize, bool isIq, int fastConvolutionThreshold, BoomaFirKernel kernel):
+    HFilter<int16_t>(id, consumer, blocksize) {
+
+    Init(coefficients, taps, blocksize, isIq, fastConvolutionThreshold, kernel);
+}
+
+BoomaFirFilter::BoomaFirFilter(std::string id, HWriter<int16_t>* writer, float* coefficients, int taps, size_t blocksize, bool isIq, int fastConvolutionThreshold, BoomaFirKernel kernel):
+    HFilter<int16_t>(id, writer, blocksize) {
+
+    Init(coefficients, taps, blocksize, isIq, fastConvolutionThreshold, kernel);
+}
+
+BoomaFirFilter::~BoomaFirFilter() {
+    Release(_state);
+    Release(_next);
+}
+
+void BoomaFirFilter::Init(float* coefficients, int taps, size_t blocksize, bool isIq, int threshold, BoomaFirKernel kernel) {
+    _isIq = isIq;
+    _channels = isIq ? 2 : 1;
+    _blocksize = blocksize;
+    _threshold = threshold;
+    _next = nullptr;
+    _pending = false;
+
+    // Select kernel
+    if( kernel == FIR_KERNEL_AUTO ) {
+        kernel = GetBestKernel();
+    } else if( !IsSupported(kernel) ) {
+        HError("FIR kernel %s is not supported on this cpu, using scalar kernel", GetKernelName(kernel));
+        kernel = FIR_KERNEL_SCALAR;
+    }
+    _kernel = kernel;
+    switch( _kernel ) {
+#ifdef BOOMA_FIR_X86
+        case FIR_KERNEL_SSE2: _dot = DotSse2; break;
+        case FIR_KERNEL_AVX2: _dot = DotAvx2; break;
+#endif
+#ifdef BOOMA_FIR_NEON
+        case FIR_KERNEL_NEON: _dot = DotNeon; break;
+#endif
+        default: _dot = DotScalar; break;
+    }
+    HLog("Creating FIR filter with %d taps for %s samples using %s kernel", taps, isIq ? "IQ" : "real", GetKernelName(_kernel));
+
+    _state = Build(coefficients, taps);
+    _fast = _state->fast;
+}
+
+void BoomaFirFilter::Release(State* state) {
+    if( state == nullptr ) {
+        return;
+    }
+    if( state->fast ) {
+        delete state->fft;
+        BoomaFree(state->spectrumRe);
+        BoomaFree(state->spectrumIm);
+        BoomaFree(state->segmentRe);
+        BoomaFree(state->segmentIm);
+        for( int ch = 0; ch < _channels; ch++ ) {
+            BoomaFree(state->samples[ch]);
+        }
+        delete[] state->samples;
+    } else {
+        BoomaFree(state->coefficients);
+        for( int ch = 0; ch < _channels; ch++ ) {
+            BoomaFree(state->buffers[ch]);
+        }
+        delete[] state->buffers;
+    }
+    delete state;
+}
+
+void BoomaFirFilter::SetCoefficients(float* coefficients, int taps) {
+    State* next = Build(coefficients, taps);
+
+    // Replace any state that has not yet been picked up
+    std::lock_guard<std::mutex> lock(_mutex);
+    Release(_next);
+    _next = next;
+    _pending = true;
+}
+
+void BoomaFirFilter::Apply() {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // Keep the sample history if the filter layout does not change
+    State* next = _next;
+    if( next->fast && _state->fast && next->taps == _state->taps ) {
+        std::swap(next->samples, _state->samples);
+    } else if( !next->fast && !_state->fast && next->length == _state->length ) {
+        std::swap(next->buffers, _state->buffers);
+    }
+
+    Release(_state);
+    _state = next;
+    _next = nullptr;
+    _fast = _state->fast;
+    _pending = false;
+}
+
+BoomaFirFilter::State* BoomaFirFilter::Build(float* coefficients, int taps) {
+    State* state = new State();
+    state->taps = taps;
+    state->fast = _threshold > 0 && taps > _threshold;
+    state->coefficients = nullptr;
+    state->length = 0;
+    state->shift = 0;
+    state->buffers = nullptr;
+    state->fft = nullptr;
+    state->spectrumRe = nullptr;
+    state->spectrumIm = nullptr;
+    state->segmentRe = nullptr;
+    state->segmentIm = nullptr;
+    state->samples = nullptr;
+
+    // Use fast convolution for long filters
+    if( state->fast ) {
+
+        // Segments should be several times the filter length to keep the overlap
+        // small, but there is no gain in going beyond one segment per block
+        int size = 64;
+        while( size < 8 * taps && size < (taps - 1) + (int) _blocksize / 2 ) {
+            size <<= 1;
+        }
+        HLog("Using fast convolution with fft size %d for %d taps", size, taps);
+        state->fft = new BoomaFft(size);
+        state->spectrumRe = BoomaAllocate<float>(size);
+        state->spectrumIm = BoomaAllocate<float>(size);
+        state->segmentRe = BoomaAllocate<float>(size);
+        state->segmentIm = BoomaAllocate<float>(size);
+        state->samples = new float*[_channels];
+        int length = (taps - 1) + _blocksize / _channels;
+        for( int ch = 0; ch < _channels; ch++ ) {
+            state->samples[ch] = BoomaAllocate<float>(length);
+            memset((void*) state->samples[ch], 0, sizeof(float) * length);
+        }
+
+        // Filter spectrum, including the scaling of the inverse transform
+        for( int i = 0; i < size; i++ ) {
+            state->spectrumRe[i] = i < taps ? coefficients[i] / (float) size : 0;
+            state->spectrumIm[i] = 0;
+        }
+        state->fft->Forward(state->spectrumRe, state->spectrumIm);
+        return state;
+    }
+
+    state->length = ((taps + 15) / 16) * 16;
+    state->coefficients = BoomaAllocate<int16_t>(state->length);
+    state->buffers = new int16_t*[_channels];
+    int size = (state->length - 1) + _blocksize / _channels;
+    for( int ch = 0; ch < _channels; ch++ ) {
+        state->buffers[ch] = BoomaAllocate<int16_t>(size);
+        memset((void*) state->buffers[ch], 0, sizeof(int16_t) * size);
+    }
+
+    // Find the largest shift where no coefficient overflows an int16 and no full
+    // scale input can overflow the int32 accumulator
+    double max = 0;
+    double sum = 0;
+    for( int i = 0; i < taps; i++ ) {
+        max = fabs(coefficients[i]) > max ? fabs(coefficients[i]) : max;
+        sum += fabs(coefficients[i]);
+    }
+    state->shift = 15;
+    while( state->shift > 0 && (max * (1 << state->shift) > 32767 || sum * (1 << state->shift) >= 65536) ) {
+        state->shift--;
+    }
+
+    // Reverse the coefficients so that each output is a straight dot product, padding goes in front
+    memset((void*) state->coefficients, 0, sizeof(int16_t) * state->length);
+    for( int i = 0; i < taps; i++ ) {
+        long value = lrint(coefficients[i] * (1 << state->shift));
+        state->coefficients[state->length - 1 - i] = value > 32767 ? 32767 : (value < -32768 ? -32768 : value);
+    }
+    return state;
+}
+
+void BoomaFirFilter::Filter(int16_t* src, int16_t* dest, size_t blocksize) {
+
+    if( blocksize != _blocksize ) {
+        HError("Requested blocksize %d differs from the filter blocksize %d", blocksize, _blocksize);
+        return;
+    }
+
+    // Pick up new coefficients
+    if( _pending ) {
+        Apply();
+    }
+
+    if( _state->fast ) {
+        FilterFast(_state, src, dest);
+    } else {
+        FilterDirect(_state, src, dest);
+    }
+}
+
+void BoomaFirFilter::FilterDirect(State* state, int16_t* src, int16_t* dest) {
+
+    int samples = _blocksize / _channels;
+    int32_t round = state->shift > 0 ? 1 << (state->shift - 1) : 0;
+    for( int ch = 0; ch < _channels; ch++ ) {
+        int16_t* buffer = state->buffers[ch];
+
+        // Append the new samples after the history
+        int16_t* window = &buffer[state->length - 1];
+        for( int i = 0; i < samples; i++ ) {
+            window[i] = src[i * _channels + ch];
+        }
+
+        for( int n = 0; n < samples; n++ ) {
+            int32_t value = (_dot(state->coefficients, &buffer[n], state->length) + round) >> state->shift;
+            dest[n * _channels + ch] = value > 32767 ? 32767 : (value < -32768 ? -32768 : value);
+        }
+
+        // Keep the history for the next block
+        memmove((void*) buffer, (void*) &buffer[samples], sizeof(int16_t) * (state->length - 1));
+    }
+}
+
+void BoomaFirFilter::FilterFast(State* state, int16_t* src, int16_t* dest) {
+
+    // Append the new samples after the history
+    int samples = _blocksize / _channels;
+    for( int ch = 0; ch < _channels; ch++ ) {
+        float* window = &state->samples[ch][state->taps - 1];
+        for( int i = 0; i < samples; i++ ) {
+            window[i] = src[i * _channels + ch];
+        }
+    }
+
+    // Complex input, I and Q or the first and second half of a real block. Each
+    // half of a real block has 'taps - 1' samples history before it as well
+    int count = _blocksize / 2;
+    float* re = state->samples[0];
+    float* im = _isIq ? state->samples[1] : &state->samples[0][count];
+
+    // Overlap-save, each segment produces 'size - (taps - 1)' new samples
+    int size = state->fft->GetSize();
+    int step = size - (state->taps - 1);
+    for( int start = 0; start < count; start += step ) {
+        int available = (state->taps - 1) + count - start;
+        if( available > size ) {
+            available = size;
+        }
+        memcpy((void*) state->segmentRe, (void*) &re[start], sizeof(float) * available);
+        memcpy((void*) state->segmentIm, (void*) &im[start], sizeof(float) * available);
+        memset((void*) &state->segmentRe[available], 0, sizeof(float) * (size - available));
+        memset((void*) &state->segmentIm[available], 0, sizeof(float) * (size - available));
+
+        state->fft->Forward(state->segmentRe, state->segmentIm);
+        for( int i = 0; i < size; i++ ) {
+            float a = state->segmentRe[i] * state->spectrumRe[i] - state->segmentIm[i] * state->spectrumIm[i];
+            float b = state->segmentRe[i] * state->spectrumIm[i] + state->segmentIm[i] * state->spectrumRe[i];
+            state->segmentRe[i] = a;
+            state->segmentIm[i] = b;
+        }
+        state->fft->Inverse(state->segmentRe, state->segmentIm);
+
+        int outputs = count - start < step ? count - start : step;
+        for( int n = 0; n < outputs; n++ ) {
+            float a = state->segmentRe[state->taps - 1 + n];
+            float b = state->segmentIm[state->taps - 1 + n];
+            int16_t i = a > 32767 ? 32767 : (a < -32768 ? -32768 : (int16_t) lrintf(a));
+            int16_t q = b > 32767 ? 32767 : (b < -32768 ? -32768 : (int16_t) lrintf(b));
+            if( _isIq ) {
+                dest[(start + n) * 2] = i;
+                dest[(start + n) * 2 + 1] = q;
+            } else {
+                dest[start + n] = i;
+                dest[count + start + n] = q;
+            }
+        }
+    }
+
+    // Keep the history for the next block
+    for( int ch = 0; ch < _channels; ch++ ) {
+        memmove((void*) state->samples[ch], (void*) &state->samples[ch][samples], sizeof(float) * (state->taps - 1));
+    }
+}
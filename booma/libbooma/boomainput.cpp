@@ -1,13 +1,23 @@
+#include <algorithm>
+
 #include "boomainput.h"
+#include "boomakaiserbesseldesigner.h"
 
 BoomaInput::BoomaInput(ConfigOptions* opts, bool* isTerminated):
         _inputReader(nullptr),
+        _fileReader(nullptr),
         _rfWriter(nullptr),
+        _rfRecorder(nullptr),
         _rfSplitter(nullptr),
         _rfBreaker(nullptr),
         _rfBuffer(nullptr),
         _networkProcessor(nullptr),
         _streamProcessor(nullptr),
+        _blockTimer(nullptr),
+        _threadedReader(nullptr),
+        _timeShift(nullptr),
+        _profiler(nullptr),
+        _latency(nullptr),
         _decimatorGain(nullptr),
         _decimatorAgc(nullptr),
         _ifMultiplier(nullptr),
@@ -15,15 +25,15 @@ BoomaInput::BoomaInput(ConfigOptions* opts, bool* isTerminated):
         _iqDecimator(nullptr),
         _firDecimator(nullptr),
         _decimator(nullptr),
+        _polyphaseDecimator(nullptr),
+        _cicDecimator(nullptr),
+        _rationalResampler(nullptr),
         _inputIqFirFilter(nullptr),
         _inputFirFilter(nullptr),
         _rfDelay(nullptr),
         _preamp(nullptr),
+        _rfFftGate(nullptr),
         _rfFft(nullptr),
-        _rfFftWindow(nullptr),
-        _rfFftWriter(nullptr),
-        _rfSpectrum(nullptr),
-        _rfFftSize(1024),
         _rfFftGain(nullptr) {
 
     // If we are using an IQ device as input, then datatype should not be REAL
@@ -50,8 +60,20 @@ BoomaInput::BoomaInput(ConfigOptions* opts, bool* isTerminated):
         opts->SetFrequency(0);
         opts->SetShift(0);
         opts->SetRtlsdrAdjust(0);
+
+        // SigMF recordings know the frequency they were tuned to
+        BoomaSigMFMetadata metadata;
+        if( opts->GetPcmFile().find(".sigmf-") != std::string::npos && metadata.Read(opts->GetPcmFile()) ) {
+            HLog("Restoring SigMF recording frequency %ld", metadata.Frequency);
+            opts->SetFrequency(metadata.Frequency);
+        }
     }
 
+    // Stage profiling and latency measurement (does nothing unless enabled)
+    _profiler = new BoomaProfiler(opts->GetEnableProfiling());
+    _latency = new BoomaLatency(opts->GetEnableLatency());
+    int channels = opts->GetInputSourceDataType() != REAL_INPUT_SOURCE_DATA_TYPE ? 2 : 1;
+
     // Set default frequencies
     HLog("Calculating initial internal frequencies");
     SetReaderFrequencies(opts, opts->GetFrequency());
@@ -60,55 +82,75 @@ BoomaInput::BoomaInput(ConfigOptions* opts, bool* isTerminated):
     if( opts->GetUseRemoteHead()) {
 
         HLog("Creating input reader for remote head");
-        HReader<int16_t>* reader = SetInputReader(opts);
+        HReader<int16_t>* reader = _profiler->Wrap("input_reader", SetInputReader(opts));
 
         HLog("Setting decimation for high rate input");
         reader = SetDecimation(opts, reader);
 
+        HLog("Setting optional input thread");
+        reader = SetInputThread(opts, reader);
+
         HLog("Initializing network processor with selected input device");
-        _networkProcessor = new HNetworkProcessor<int16_t>("input_network_processor_remote", opts->GetRemoteDataPort(), opts->GetRemoteCommandPort(), reader, BLOCKSIZE, isTerminated);
+        _networkProcessor = new HNetworkProcessor<int16_t>("input_network_processor_remote", opts->GetRemoteDataPort(), opts->GetRemoteCommandPort(), reader, opts->GetBlocksize(), isTerminated);
         return;
     }
 
     // If we are a remote head, then initialize a network processor, otherwise configure a local input
     if( opts->GetIsRemoteHead() ) {
         HLog("Initializing network processor with remote input at %s:%d", opts->GetRemoteServer().c_str(), opts->GetRemoteDataPort());
-        _networkProcessor = new HNetworkProcessor<int16_t>("input_network_processor_remote_head", opts->GetRemoteServer().c_str(), opts->GetRemoteDataPort(), opts->GetRemoteCommandPort(), BLOCKSIZE, isTerminated);
+        _networkProcessor = new HNetworkProcessor<int16_t>("input_network_processor_remote_head", opts->GetRemoteServer().c_str(), opts->GetRemoteDataPort(), opts->GetRemoteCommandPort(), opts->GetBlocksize(), isTerminated);
     }
     else {
         HLog("Creating input reader for local hardware device");
-        HReader<int16_t>* reader = SetInputReader(opts);
+        HReader<int16_t>* reader = _profiler->Wrap("input_reader", _latency->Capture(SetInputReader(opts), opts->GetInputSampleRate() * channels));
 
         HLog("Setting decimation for high rate input");
         reader = SetDecimation(opts, reader);
 
+        HLog("Setting optional input thread");
+        reader = SetInputThread(opts, reader);
+
+        HLog("Setting optional time shift buffer");
+        reader = SetTimeShift(opts, reader, channels);
+
+        // Optionally time each block passing through the chain
+        if( opts->GetEnableBlockTiming() ) {
+            HLog("Adding block timer");
+            _blockTimer = new BoomaBlockTimer("input_block_timer", reader);
+            reader = _blockTimer;
+        }
+
         HLog("Initializing stream processor with selected input device");
-        _streamProcessor = new HStreamProcessor<int16_t>("input_stream_processor", reader, BLOCKSIZE, isTerminated);
+        _streamProcessor = new HStreamProcessor<int16_t>("input_stream_processor", reader, opts->GetBlocksize(), isTerminated);
     }
 
-    // Calculate RF fft spectrum size
-    _rfSpectrumSize = _rfFftSize / 2;
-    _rfSpectrum = new double[_rfSpectrumSize];
-    memset((void*) _rfSpectrum, 0, sizeof(double) * _rfSpectrumSize);
-
     // Setup a splitter to split off rf dump and spectrum calculation
     HLog("Setting up input RF splitter and RF optional output dump");
-    _rfSplitter = new HSplitter<int16_t>("input_rf_splitter", (_networkProcessor != nullptr ? (HProcessor<int16_t>*) _networkProcessor : (HProcessor<int16_t>*) _streamProcessor)->Consumer());
-    _rfDelay = new HDelay<int16_t>("input_rf_delay", _rfSplitter->Consumer(), BLOCKSIZE, opts->GetOutputSampleRate(), 10);
-    _rfBreaker = new HBreaker<int16_t>("input_rf_breaker", _rfDelay->Consumer(), !opts->GetDumpRf(), BLOCKSIZE);
-    _rfBuffer = new HBufferedWriter<int16_t>("input_rf_buffer", _rfBreaker->Consumer(), BLOCKSIZE, opts->GetReservedBuffers(), opts->GetEnableBuffers());
+    _rfSplitter = new BoomaSplitter("input_rf_splitter", _profiler->Wrap("input_rf_splitter", _latency->Probe("input", (_networkProcessor != nullptr ? (HProcessor<int16_t>*) _networkProcessor : (HProcessor<int16_t>*) _streamProcessor)->Consumer(), opts->GetOutputSampleRate() * channels)), opts->GetBlocksize());
+    _rfDelay = new BoomaDelay("input_rf_delay", _rfSplitter, opts->GetBlocksize(), opts->GetOutputSampleRate() * channels, opts->GetDumpPreroll());
+    _rfBreaker = new HBreaker<int16_t>("input_rf_breaker", _rfDelay->Consumer(), !opts->GetDumpRf(), opts->GetBlocksize());
+    _rfBuffer = new HBufferedWriter<int16_t>("input_rf_buffer", _profiler->Wrap("input_rf_buffer", _rfBreaker->Consumer()), opts->GetBlocksize(), opts->GetReservedBuffers(), opts->GetEnableBuffers());
     std::string dumpfile = "INPUT_" + (opts->GetDumpFileSuffix() == "" ? std::to_string(std::time(nullptr)) : opts->GetDumpFileSuffix());
-    if( opts->GetDumpRfFileFormat() == WAV ) {
+    if( opts->GetDumpRfFileFormat() != SIGMF && opts->GetDumpThreadBlocks() > 0 ) {
+        _rfWriter = new BoomaDumpWriter("input_rf_dump_writer", dumpfile, opts->GetDumpRfFileFormat() == WAV, _rfBuffer->Consumer(), opts->GetOutputSampleRate(), channels,
+                                        opts->GetBlocksize(), opts->GetDumpThreadBlocks(), opts->GetDumpRotateSize(), opts->GetDumpRotateDuration());
+    } else if( opts->GetDumpRfFileFormat() == WAV ) {
         _rfWriter = new HWavWriter<int16_t>("input_rf_wav_writer", (dumpfile + ".wav").c_str(), H_SAMPLE_FORMAT_INT_16, 1, opts->GetOutputSampleRate(), _rfBuffer->Consumer(), true);
+    } else if( opts->GetDumpRfFileFormat() == SIGMF ) {
+
+        // Events are placed after the frames still held by the rf delay
+        _rfRecorder = new BoomaSigMFWriter("input_rf_sigmf_writer", dumpfile, _rfBuffer->Consumer(), opts->GetOutputSampleRate(), channels == 2, opts->GetOriginalInputSourceType(),
+                                           _hardwareFrequency, _virtualFrequency, opts->GetRfGain(), ((long) opts->GetOutputSampleRate() * channels * opts->GetDumpPreroll() / opts->GetBlocksize()) * opts->GetBlocksize() / channels,
+                                           opts->GetBlocksize(), opts->GetDumpThreadBlocks());
+        _rfWriter = _rfRecorder;
     } else {
         _rfWriter = new HFileWriter<int16_t>("input_rf_pcm_writer", (dumpfile + ".pcm").c_str(), _rfBuffer->Consumer(), true);
     }
 
-    // Add RF spectrum calculation
-    _rfFftWindow = new HRectangularWindow<int16_t>();
-    _rfFftGain = new HGain<int16_t>("input_rf_spectrum_gain", _rfSplitter->Consumer(), 1, BLOCKSIZE);
-    _rfFft = new HFftOutput<int16_t>("input_rf_spectrum_output", _rfFftSize, RFFFT_AVERAGING_COUNT, RFFFT_SKIP, _rfFftGain->Consumer(), _rfFftWindow, opts->GetInputSourceDataType() != REAL_INPUT_SOURCE_DATA_TYPE);
-    _rfFftWriter = HCustomWriter<HFftResults>::Create<BoomaInput>("input_rf_spectrum_writer", this, &BoomaInput::RfFftCallback, _rfFft->Consumer());
+    // Add RF spectrum calculation, only running while someone reads the spectrum
+    _rfFftGate = new BoomaDemandGate("input_rf_spectrum_gate", _rfSplitter->Consumer(), opts->GetSpectrumTimeout());
+    _rfFftGain = new HGain<int16_t>("input_rf_spectrum_gain", _profiler->Wrap("input_rf_spectrum_gain", _rfFftGate->Consumer()), 1, opts->GetBlocksize());
+    _rfFft = new BoomaSpectrum("input_rf_spectrum_output", _profiler->Wrap("input_rf_spectrum_output", _rfFftGain->Consumer()), opts->GetOutputSampleRate(), opts->GetInputSourceDataType() != REAL_INPUT_SOURCE_DATA_TYPE, RECTANGULAR_WINDOW, 1, opts->GetRfFftSize(), opts->GetRfFftOverlap(), opts->GetRfFftAveraging());
 
     // Add preamp
     HLog("Setting up the preamp");
@@ -127,6 +169,9 @@ BoomaInput::~BoomaInput() {
 
     SAFE_DELETE(_streamProcessor);
     SAFE_DELETE(_networkProcessor);
+    SAFE_DELETE(_blockTimer);
+    SAFE_DELETE(_timeShift);
+    SAFE_DELETE(_threadedReader);
 
     SAFE_DELETE(_decimatorGain);
     SAFE_DELETE(_decimatorAgc);
@@ -135,6 +180,9 @@ BoomaInput::~BoomaInput() {
     SAFE_DELETE(_iqDecimator);
     SAFE_DELETE(_firDecimator);
     SAFE_DELETE(_decimator);
+    SAFE_DELETE(_polyphaseDecimator);
+    SAFE_DELETE(_cicDecimator);
+    SAFE_DELETE(_rationalResampler);
     SAFE_DELETE(_inputIqFirFilter);
     SAFE_DELETE(_inputFirFilter);
 
@@ -147,9 +195,10 @@ BoomaInput::~BoomaInput() {
     SAFE_DELETE(_preamp);
 
     SAFE_DELETE(_rfFft);
-    SAFE_DELETE(_rfFftWriter);
-    SAFE_DELETE(_rfFftWindow);
-    SAFE_DELETE(_rfSpectrum);
+    SAFE_DELETE(_rfFftGate);
+
+    SAFE_DELETE(_profiler);
+    SAFE_DELETE(_latency);
 }
 
 HReader<int16_t>* BoomaInput::SetInputReader(ConfigOptions* opts) {
@@ -160,20 +209,26 @@ HReader<int16_t>* BoomaInput::SetInputReader(ConfigOptions* opts) {
             case AUDIO_DEVICE:
                 HLog("Initializing audio input device %d", opts->GetInputDevice());
                 _inputReader = new HSoundcardReader<int16_t>("input_soundcard_reader", opts->GetInputDevice(), opts->GetInputSampleRate(), 1,
-                                                             H_SAMPLE_FORMAT_INT_16, BLOCKSIZE);
+                                                             H_SAMPLE_FORMAT_INT_16, opts->GetBlocksize());
                 break;
             case SIGNAL_GENERATOR:
                 HLog("Initializing signal generator at frequency %d", opts->GetSignalGeneratorFrequency());
-                _inputReader = new HSineGenerator<int16_t>("input_signal_generator_reader", opts->GetInputSampleRate(),
-                                                           opts->GetSignalGeneratorFrequency(), 200);
+                _inputReader = new BoomaToneGenerator("input_signal_generator_reader", opts->GetInputSampleRate(),
+                                                       opts->GetSignalGeneratorFrequency(), 200, opts->GetBlocksize());
                 break;
             case PCM_FILE:
                 HLog("Initializing pcm file reader for input file %s", opts->GetPcmFile().c_str());
-                _inputReader = new HFileReader<int16_t>("input_pcm_reader", opts->GetPcmFile());
+                _fileReader = new BoomaMappedFileReader("input_pcm_reader", opts->GetPcmFile(), false, opts->GetInputSampleRate(),
+                                                        opts->GetInputSourceDataType() != REAL_INPUT_SOURCE_DATA_TYPE ? 2 : 1,
+                                                        opts->GetInputFileSpeed(), opts->GetInputFileLoop());
+                _inputReader = _fileReader;
                 break;
             case WAV_FILE:
                 HLog("Initializing wav file reader for input file %s", opts->GetWavFile().c_str());
-                _inputReader = new HWavReader<int16_t>("input_wav_reader", opts->GetWavFile().c_str());
+                _fileReader = new BoomaMappedFileReader("input_wav_reader", opts->GetWavFile(), true, opts->GetInputSampleRate(),
+                                                        opts->GetInputSourceDataType() != REAL_INPUT_SOURCE_DATA_TYPE ? 2 : 1,
+                                                        opts->GetInputFileSpeed(), opts->GetInputFileLoop());
+                _inputReader = _fileReader;
                 break;
             case SILENCE:
                 HLog("Initializing nullreader");
@@ -187,7 +242,7 @@ HReader<int16_t>* BoomaInput::SetInputReader(ConfigOptions* opts) {
                              opts->GetRtlsdrGain());
                         _inputReader = new HRtl2832Reader<int16_t>("input_rtl2832_iq_reader", opts->GetInputDevice(), opts->GetInputSampleRate(),
                                                                    HRtl2832::MODE::IQ_SAMPLES, opts->GetRtlsdrGain(),
-                                                                   _hardwareFrequency, BLOCKSIZE, 0,
+                                                                   _hardwareFrequency, opts->GetBlocksize(), 0,
                                                                    opts->GetRtlsdrCorrection());
                         break;
                     case InputSourceDataType::I_INPUT_SOURCE_DATA_TYPE:
@@ -196,7 +251,7 @@ HReader<int16_t>* BoomaInput::SetInputReader(ConfigOptions* opts) {
                              opts->GetRtlsdrGain());
                         _inputReader = new HRtl2832Reader<int16_t>("input_rtl2832_i_reader", opts->GetInputDevice(), opts->GetInputSampleRate(),
                                                                    HRtl2832::MODE::I_SAMPLES, opts->GetRtlsdrGain(),
-                                                                   _hardwareFrequency, BLOCKSIZE, 0,
+                                                                   _hardwareFrequency, opts->GetBlocksize(), 0,
                                                                    opts->GetRtlsdrCorrection());
                         break;
                     case InputSourceDataType::Q_INPUT_SOURCE_DATA_TYPE:
@@ -205,7 +260,7 @@ HReader<int16_t>* BoomaInput::SetInputReader(ConfigOptions* opts) {
                              opts->GetRtlsdrGain());
                         _inputReader = new HRtl2832Reader<int16_t>("input_rtl2832_q_reader", opts->GetInputDevice(), opts->GetInputSampleRate(),
                                                                    HRtl2832::MODE::Q_SAMPLES, opts->GetRtlsdrGain(),
-                                                                   _hardwareFrequency, BLOCKSIZE, 0,
+                                                                   _hardwareFrequency, opts->GetBlocksize(), 0,
                                                                    opts->GetRtlsdrCorrection());
                         break;
                     case InputSourceDataType::REAL_INPUT_SOURCE_DATA_TYPE:
@@ -214,7 +269,7 @@ HReader<int16_t>* BoomaInput::SetInputReader(ConfigOptions* opts) {
                              opts->GetRtlsdrGain());
                         _inputReader = new HRtl2832Reader<int16_t>("input_rtl2832_real_reader", opts->GetInputDevice(), opts->GetInputSampleRate(),
                                                                    HRtl2832::MODE::REAL_SAMPLES, opts->GetRtlsdrGain(),
-                                                                   _hardwareFrequency, BLOCKSIZE, 0,
+                                                                   _hardwareFrequency, opts->GetBlocksize(), 0,
                                                                    opts->GetRtlsdrCorrection());
                         break;
                     default:
@@ -238,6 +293,14 @@ bool BoomaInput::SetDumpRf(bool enabled) {
     return !_rfBreaker->GetOff();
 }
 
+unsigned long BoomaInput::GetDroppedDumpBlocks() {
+    if( _rfRecorder != nullptr ) {
+        return _rfRecorder->GetDroppedBlocks();
+    }
+    BoomaDumpWriter* writer = dynamic_cast<BoomaDumpWriter*>(_rfWriter);
+    return writer != nullptr ? writer->GetDroppedBlocks() : 0;
+}
+
 void BoomaInput::Run(int blocks) {
     if( blocks > 0 ) {
         (_networkProcessor != NULL ? (HProcessor<int16_t>*) _networkProcessor : (HProcessor<int16_t>*) _streamProcessor)->Run(blocks);
@@ -283,10 +346,13 @@ bool BoomaInput::SetFrequency(ConfigOptions* opts, int frequency) {
 
     // Calculate new IF and hardware frequencies
     SetReaderFrequencies(opts, frequency);
+    if( _rfRecorder != nullptr ) {
+        _rfRecorder->Retune(_hardwareFrequency, _virtualFrequency);
+    }
 
     // If we have a bandpass filter as inputfilter (REAL input), then move it
     if( _inputFirFilter != nullptr ) {
-        _inputFirFilter->SetCoefficients(HBandpassKaiserBessel<int16_t>(_ifFrequency - (opts->GetInputFilterWidth() / 2), _ifFrequency + (opts->GetInputFilterWidth() / 2), opts->GetOutputSampleRate(), 51, 50).Calculate(),51);
+        _inputFirFilter->SetCoefficients(BoomaKaiserBesselDesigner::Bandpass(_ifFrequency - (opts->GetInputFilterWidth() / 2), _ifFrequency + (opts->GetInputFilterWidth() / 2), opts->GetOutputSampleRate(), 51, 50, false).data(),51);
     }
 
     // No need to propagate a set-frequency command
@@ -309,15 +375,15 @@ bool BoomaInput::SetFrequency(ConfigOptions* opts, int frequency) {
     }
 }
 
-bool BoomaInput::GetDecimationRate(int inputRate, int outputRate, int* first, int* second) {
+bool BoomaInput::GetDecimationRate(int inputRate, int outputRate, int blocksize, int* first, int* second) {
 
     // Run through all possible factors for the current blocksize
     // The first decimator only accepts factors that divide cleanly
-    // up into the BLOCKSIZE
-    for( int i = BLOCKSIZE; i > 0; i-- ) {
+    // up into the blocksize
+    for( int i = blocksize; i > 0; i-- ) {
 
         // Check if we can divide without remainer
-        if( BLOCKSIZE % i == 0 ) {
+        if( blocksize % i == 0 ) {
 
             // Check if the factor also divides into a integer samplerate
             if( inputRate % i == 0 ) {
@@ -336,8 +402,8 @@ bool BoomaInput::GetDecimationRate(int inputRate, int outputRate, int* first, in
 
                     // Run through all sensible factors for the second decimator.
                     // This decimator supports asymmetric decimation factors, so factors
-                    // that do not divide cleanly up into BLOCKSIZE is also valid
-                    for( int j = 1; j < BLOCKSIZE; j++ ) {
+                    // that do not divide cleanly up into the blocksize is also valid
+                    for( int j = 1; j < blocksize; j++ ) {
 
                         if( intermediate / j == outputRate ) {
                             *first = i;
@@ -353,6 +419,75 @@ bool BoomaInput::GetDecimationRate(int inputRate, int outputRate, int* first, in
     return false;
 }
 
+HReader<int16_t>* BoomaInput::SetDecimatorGain(ConfigOptions* opts, HReader<int16_t>* previous) {
+
+    // Decimators require a tiny bit of gain to overcome the loss in the FIR filters
+    if( opts->GetDecimatorGain() > 0 ) {
+        HLog("Using fixed gain=%d before decimator", opts->GetDecimatorGain());
+        _decimatorGain = new HGain<int16_t>("input_decimator_gain_fixed", previous, opts->GetDecimatorGain(), opts->GetBlocksize());
+        return _profiler->Wrap("input_decimator_gain_fixed", _decimatorGain->Reader());
+    } else {
+        HLog("Using agc at level=%d before decimator", opts->GetDecimatorAgcLevel());
+        _decimatorAgc = new HAgc<int16_t>("input_decimator_gain_agc", previous, opts->GetDecimatorAgcLevel(), 50, opts->GetBlocksize(), 6, true);
+        return _profiler->Wrap("input_decimator_gain_agc", _decimatorAgc->Reader());
+    }
+}
+
+HReader<int16_t>* BoomaInput::SetResampling(ConfigOptions* opts, HReader<int16_t>* previous, bool isIq) {
+
+    // Decimate by the largest integer factor that keeps the rate at or above twice
+    // the output rate, this keeps the interpolation factor and the filter small
+    int factor = 1;
+    for( int d = opts->GetInputSampleRate() / (2 * opts->GetOutputSampleRate()); d > 1; d-- ) {
+        if( opts->GetInputSampleRate() % d == 0 ) {
+            factor = d;
+            break;
+        }
+    }
+
+    HReader<int16_t>* reader = SetDecimatorGain(opts, previous);
+    if( factor > 1 ) {
+        HLog("Creating polyphase decimator with factor %d = %d -> %d with FIR filter size %d", factor, opts->GetInputSampleRate(), opts->GetInputSampleRate() / factor, opts->GetFirFilterSize());
+        _polyphaseDecimator = new BoomaPolyphaseDecimator(
+            "input_resampler_decimator",
+            reader,
+            factor,
+            BoomaKaiserBesselDesigner::Lowpass(opts->GetDecimatorCutoff(), opts->GetInputSampleRate(), opts->GetFirFilterSize(), isIq ? 120 : 96).data(),
+            opts->GetFirFilterSize(),
+            opts->GetBlocksize(),
+            isIq);
+        reader = _profiler->Wrap("input_resampler_decimator", _polyphaseDecimator);
+    }
+
+    // Resample the remaining rational ratio
+    int rate = opts->GetInputSampleRate() / factor;
+    int divisor = rate;
+    for( int remainder = opts->GetOutputSampleRate(); remainder != 0; ) {
+        int next = divisor % remainder;
+        divisor = remainder;
+        remainder = next;
+    }
+    int interpolation = opts->GetOutputSampleRate() / divisor;
+    int decimation = rate / divisor;
+    int taps = BoomaRationalResampler::GetTaps(interpolation, rate, opts->GetOutputSampleRate(), opts->GetDecimatorCutoff(), 96);
+    if( taps > MAX_RESAMPLER_TAPS ) {
+        HError("Resampling %d -> %d as %d/%d requires %d taps", rate, opts->GetOutputSampleRate(), interpolation, decimation, taps);
+        throw new BoomaInputException("No usable rational resampling ratio from the input samplerate to the output samplerate");
+    }
+
+    HLog("Creating rational resampler %d/%d = %d -> %d with %d taps", interpolation, decimation, rate, opts->GetOutputSampleRate(), taps);
+    _rationalResampler = new BoomaRationalResampler(
+        "input_rational_resampler",
+        reader,
+        interpolation,
+        decimation,
+        BoomaKaiserBesselDesigner::Lowpass(opts->GetDecimatorCutoff(), rate * interpolation, taps, 96).data(),
+        taps,
+        opts->GetBlocksize(),
+        isIq);
+    return _profiler->Wrap("input_rational_resampler", _rationalResampler);
+}
+
 HReader<int16_t>* BoomaInput::SetDecimation(ConfigOptions* opts, HReader<int16_t>* previous) {
 
     // Decimation not needed if not an rtl-sdr
@@ -367,27 +502,79 @@ HReader<int16_t>* BoomaInput::SetDecimation(ConfigOptions* opts, HReader<int16_t
         return previous;
     }
 
-    // Sanity check
+    // No integer divisor exists, use rational resampling
+    bool isIq = opts->GetInputSourceDataType() != REAL_INPUT_SOURCE_DATA_TYPE;
     if (opts->GetInputSampleRate() % opts->GetOutputSampleRate() != 0) {
-        throw new BoomaInputException("no integer divisor exists to decimate the input samplerate to the output samplerate");
+        return SetResampling(opts, previous, isIq);
+    }
+
+    // Polyphase decimation is done in a single stage with any integer factor
+    if( opts->GetDecimationMethod() == POLYPHASE_DECIMATION ) {
+        int factor = opts->GetInputSampleRate() / opts->GetOutputSampleRate();
+        HLog("Creating polyphase decimator with factor %d = %d -> %d with FIR filter size %d", factor, opts->GetInputSampleRate(), opts->GetOutputSampleRate(), opts->GetFirFilterSize());
+        _polyphaseDecimator = new BoomaPolyphaseDecimator(
+            "input_polyphase_decimator",
+            SetDecimatorGain(opts, previous),
+            factor,
+            BoomaKaiserBesselDesigner::Lowpass(opts->GetDecimatorCutoff(), opts->GetInputSampleRate(), opts->GetFirFilterSize(), isIq ? 120 : 96).data(),
+            opts->GetFirFilterSize(),
+            opts->GetBlocksize(),
+            isIq);
+        return _profiler->Wrap("input_polyphase_decimator", _polyphaseDecimator);
+    }
+
+    // CIC decimation down to 4-8 times the output rate (if possible), followed by a
+    // compensating FIR decimator doing the final filtering and decimation
+    if( opts->GetDecimationMethod() == CIC_DECIMATION ) {
+        int factor = opts->GetInputSampleRate() / opts->GetOutputSampleRate();
+        int firFactor = BoomaCicDecimator::GetFinalFactor(factor);
+        int cicFactor = factor / firFactor;
+        int rate = opts->GetInputSampleRate() / cicFactor;
+        float attenuation = isIq ? 120 : 96;
+
+        // Both the CIC aliases and the FIR stopband must reach the attenuation at the
+        // passband edge, anything folding down into the passband starts at 'output - cutoff'
+        int stopband = opts->GetOutputSampleRate() - opts->GetDecimatorCutoff();
+        int taps = std::max(opts->GetFirFilterSize(), BoomaCicCompensation::GetTaps(rate, opts->GetDecimatorCutoff(), stopband, attenuation));
+
+        HReader<int16_t>* reader = SetDecimatorGain(opts, previous);
+        int stages = CIC_STAGES;
+        if( cicFactor > 1 ) {
+            stages = std::max(CIC_STAGES, BoomaCicDecimator::GetStages(cicFactor, (double) opts->GetDecimatorCutoff() / rate, attenuation));
+            if( BoomaCicDecimator::GetRegisterBits(cicFactor, stages) > 64 ) {
+                HError("CIC decimator with factor %d and %d stages needs more than 64 bit registers", cicFactor, stages);
+                throw new BoomaInputException("Decimation factor is too large for the CIC decimator");
+            }
+
+            HLog("Creating CIC decimator with factor %d and %d stages = %d -> %d", cicFactor, stages, opts->GetInputSampleRate(), rate);
+            _cicDecimator = new BoomaCicDecimator("input_cic_decimator", reader, cicFactor, stages, opts->GetBlocksize(), isIq);
+            reader = _profiler->Wrap("input_cic_decimator", _cicDecimator);
+        }
+
+        HLog("Creating CIC compensation FIR decimator with factor %d = %d -> %d with FIR filter size %d", firFactor, rate, opts->GetOutputSampleRate(), taps);
+        float* coefficients = BoomaCicCompensation(cicFactor, stages, opts->GetOutputSampleRate() / 2, rate, taps, attenuation).Calculate();
+        _polyphaseDecimator = new BoomaPolyphaseDecimator(
+            "input_cic_compensation_decimator",
+            reader,
+            firFactor,
+            coefficients,
+            taps,
+            opts->GetBlocksize(),
+            isIq);
+        delete[] coefficients;
+        return _profiler->Wrap("input_cic_compensation_decimator", _polyphaseDecimator);
     }
 
     // Get decimation factors
     int firstFactor;
     int secondFactor;
-    if (!GetDecimationRate(opts->GetInputSampleRate(), opts->GetOutputSampleRate(), &firstFactor, &secondFactor)) {
+    if (!GetDecimationRate(opts->GetInputSampleRate(), opts->GetOutputSampleRate(), opts->GetBlocksize(), &firstFactor, &secondFactor)) {
         HError("No possible decimation factors to go from %d to %d", opts->GetInputSampleRate(), opts->GetOutputSampleRate());
         throw new BoomaInputException("No possible decimation factors to go from the input samplerate to the output samplerate");
     }
 
-    // Decimators require a tiny bit of gain to overcome the loss in the FIR filters
-    if( opts->GetDecimatorGain() > 0 ) {
-        HLog("Using fixed gain=%d before decimator", opts->GetDecimatorGain());
-        _decimatorGain = new HGain<int16_t>("input_decimator_gain_fixed", previous, opts->GetDecimatorGain(), BLOCKSIZE);
-    } else {
-        HLog("Using agc at level=%d before decimator", opts->GetDecimatorAgcLevel());
-        _decimatorAgc = new HAgc<int16_t>("input_decimator_gain_agc", previous, opts->GetDecimatorAgcLevel(), 50, BLOCKSIZE, 6, true);
-    }
+    // Add gain before the decimators
+    HReader<int16_t>* gain = SetDecimatorGain(opts, previous);
 
     // Decimation for IQ signals
     if(opts->GetInputSourceDataType() == IQ_INPUT_SOURCE_DATA_TYPE || opts->GetInputSourceDataType() == I_INPUT_SOURCE_DATA_TYPE || opts->GetInputSourceDataType() == Q_INPUT_SOURCE_DATA_TYPE ) {
@@ -396,11 +583,11 @@ HReader<int16_t>* BoomaInput::SetDecimation(ConfigOptions* opts, HReader<int16_t
         HLog("Creating FIR decimator with factor %d = %d -> %d with FIR filter size %d", firstFactor, opts->GetInputSampleRate(), opts->GetInputSampleRate() / firstFactor, opts->GetFirFilterSize());
         _iqFirDecimator = new HIqFirDecimator<int16_t>(
             "input_first_decimator_iq_fir",
-            (_decimatorGain != nullptr ? _decimatorGain : _decimatorAgc)->Reader(),
+            gain,
             firstFactor,
-            HLowpassKaiserBessel<int16_t>(opts->GetDecimatorCutoff(), opts->GetInputSampleRate(), opts->GetFirFilterSize(),120).Calculate(),
+            BoomaKaiserBesselDesigner::Lowpass(opts->GetDecimatorCutoff(), opts->GetInputSampleRate(), opts->GetFirFilterSize(),120).data(),
             opts->GetFirFilterSize(),
-            BLOCKSIZE,
+            opts->GetBlocksize(),
             true);
 
         // Second decimation stage, if needed - a regular decimator dropping the samplerate to the output samplerate
@@ -408,13 +595,13 @@ HReader<int16_t>* BoomaInput::SetDecimation(ConfigOptions* opts, HReader<int16_t
             HLog("Creating decimator with factor %d = %d -> %d", secondFactor, opts->GetInputSampleRate() / firstFactor, opts->GetOutputSampleRate());
             _iqDecimator = new HIqDecimator<int16_t>(
                     "input_second_decimator_iq",
-                    _iqFirDecimator->Reader(),
+                    _profiler->Wrap("input_first_decimator_iq_fir", _iqFirDecimator->Reader()),
                     secondFactor,
-                    BLOCKSIZE,
+                    opts->GetBlocksize(),
                     true);
-            return _iqDecimator->Reader();
+            return _profiler->Wrap("input_second_decimator_iq", _iqDecimator->Reader());
         } else {
-            return _iqFirDecimator->Reader();
+            return _profiler->Wrap("input_first_decimator_iq_fir", _iqFirDecimator->Reader());
         }
     }
 
@@ -425,19 +612,19 @@ HReader<int16_t>* BoomaInput::SetDecimation(ConfigOptions* opts, HReader<int16_t
         HLog("Creating FIR decimator with factor %d = %d -> %d and FIR filter size %d", firstFactor, opts->GetInputSampleRate(), opts->GetInputSampleRate() / firstFactor, opts->GetFirFilterSize());
         _firDecimator = new HFirDecimator<int16_t>(
                 "input_first_decimator_fir",
-                (_decimatorGain != nullptr ? _decimatorGain : _decimatorAgc)->Reader(),
+                gain,
                 firstFactor,
-                HLowpassKaiserBessel<int16_t>(opts->GetDecimatorCutoff(), opts->GetInputSampleRate(), opts->GetFirFilterSize(),96).Calculate(),
+                BoomaKaiserBesselDesigner::Lowpass(opts->GetDecimatorCutoff(), opts->GetInputSampleRate(), opts->GetFirFilterSize(),96).data(),
                 opts->GetFirFilterSize(),
-                BLOCKSIZE);
+                opts->GetBlocksize());
 
         // Second decimation stage, if needed - a regular decimator dropping the samplerate to the output samplerate
         if (secondFactor > 1) {
             HLog("Creating decimator with factor %d = %d -> %d", secondFactor, opts->GetInputSampleRate() / firstFactor, opts->GetOutputSampleRate());
-            _decimator = new HDecimator<int16_t>("input_second_decimator", _firDecimator->Reader(), 3, BLOCKSIZE);
-            return _decimator->Reader();
+            _decimator = new HDecimator<int16_t>("input_second_decimator", _profiler->Wrap("input_first_decimator_fir", _firDecimator->Reader()), 3, opts->GetBlocksize());
+            return _profiler->Wrap("input_second_decimator", _decimator->Reader());
         } else {
-            return _firDecimator->Reader();
+            return _profiler->Wrap("input_first_decimator_fir", _firDecimator->Reader());
         }
     }
 
@@ -447,6 +634,35 @@ HReader<int16_t>* BoomaInput::SetDecimation(ConfigOptions* opts, HReader<int16_t
     }
 }
 
+HReader<int16_t>* BoomaInput::SetInputThread(ConfigOptions* opts, HReader<int16_t>* previous) {
+
+    // Run everything in the same thread unless requested otherwise
+    if( opts->GetInputThreadBlocks() <= 0 ) {
+        HLog("No input thread requested");
+        return previous;
+    }
+
+    // Move the reader and the decimation to a separate thread, feeding the
+    // rest of the chain through a ring of blocks. Only live devices may drop blocks
+    bool live = opts->GetInputSourceType() == AUDIO_DEVICE || opts->GetInputSourceType() == RTLSDR;
+    HLog("Creating input thread with a ring of %d blocks", opts->GetInputThreadBlocks());
+    _threadedReader = new BoomaThreadedReader("input_threaded_reader", previous, opts->GetBlocksize(), opts->GetInputThreadBlocks(), live);
+    return _threadedReader->Reader();
+}
+
+HReader<int16_t>* BoomaInput::SetTimeShift(ConfigOptions* opts, HReader<int16_t>* previous, int channels) {
+
+    if( opts->GetTimeShift() <= 0 ) {
+        HLog("No time shift buffer requested");
+        return previous;
+    }
+
+    // Keep the decimated input so that the receiver can replay it. Only live devices may overwrite unread blocks
+    bool live = opts->GetInputSourceType() == AUDIO_DEVICE || opts->GetInputSourceType() == RTLSDR;
+    _timeShift = new BoomaTimeShift("input_time_shift", previous, opts->GetBlocksize(), opts->GetOutputSampleRate(), channels, opts->GetTimeShift(), opts->GetTimeShiftSpeed(), live, _latency);
+    return _profiler->Wrap("input_time_shift", _timeShift);
+}
+
 HWriterConsumer<int16_t>* BoomaInput::SetInputFilter(ConfigOptions* opts, HWriterConsumer<int16_t>* previous) {
 
     // Ignore shift for some input types
@@ -462,19 +678,19 @@ HWriterConsumer<int16_t>* BoomaInput::SetInputFilter(ConfigOptions* opts, HWrite
     if( opts->GetOriginalInputSourceType() == RTLSDR ) {
 
         // Add extra filter the removes (mostly) anything outside the FIR cutoff frequency
-        _inputIqFirFilter = new HIqFirFilter<int16_t>("input_iq_fir", previous, opts->GetInputFilterWidth() == 0
-                ? HLowpassKaiserBessel<int16_t>(opts->GetOutputSampleRate() / 2, opts->GetOutputSampleRate(), 51, 50).Calculate()
-                : HLowpassKaiserBessel<int16_t>(opts->GetInputFilterWidth(), opts->GetOutputSampleRate(), 51, 50).Calculate(),
-                51, BLOCKSIZE);
+        _inputIqFirFilter = new BoomaFirFilter("input_iq_fir", _profiler->Wrap("input_iq_fir", previous), opts->GetInputFilterWidth() == 0
+                ? BoomaKaiserBesselDesigner::Lowpass(opts->GetOutputSampleRate() / 2, opts->GetOutputSampleRate(), 51, 50, false).data()
+                : BoomaKaiserBesselDesigner::Lowpass(opts->GetInputFilterWidth(), opts->GetOutputSampleRate(), 51, 50, false).data(),
+                51, opts->GetBlocksize(), true, opts->GetFastConvolutionThreshold());
         return _inputIqFirFilter->Consumer();
     } else {
 
         // Add extra filter the removes (mostly) anything outside the current frequency passband frequency
-        _inputFirFilter = new HFirFilter<int16_t>("input_fir", previous,
+        _inputFirFilter = new BoomaFirFilter("input_fir", _profiler->Wrap("input_fir", previous),
             opts->GetInputFilterWidth() == 0
-                ? HLowpassKaiserBessel<int16_t>(opts->GetOutputSampleRate() / 2, opts->GetOutputSampleRate(), 51, 50).Calculate()
-                : HBandpassKaiserBessel<int16_t>(_ifFrequency - (opts->GetInputFilterWidth() / 2), _ifFrequency + (opts->GetInputFilterWidth() / 2), opts->GetOutputSampleRate(), 51, 50).Calculate(),
-            51, BLOCKSIZE);
+                ? BoomaKaiserBesselDesigner::Lowpass(opts->GetOutputSampleRate() / 2, opts->GetOutputSampleRate(), 51, 50, false).data()
+                : BoomaKaiserBesselDesigner::Bandpass(_ifFrequency - (opts->GetInputFilterWidth() / 2), _ifFrequency + (opts->GetInputFilterWidth() / 2), opts->GetOutputSampleRate(), 51, 50, false).data(),
+            51, opts->GetBlocksize(), false, opts->GetFastConvolutionThreshold());
 
         return _inputFirFilter->Consumer();
     }
@@ -486,8 +702,8 @@ bool BoomaInput::SetInputFilterWidth(ConfigOptions* opts, int width) {
     if(_inputIqFirFilter != nullptr ) {
         HLog("Setting new input filter width %d for iq filter", width);
         _inputIqFirFilter->SetCoefficients(width == 0
-                ? HLowpassKaiserBessel<int16_t>(opts->GetOutputSampleRate() / 2, opts->GetOutputSampleRate(), 51, 50).Calculate()
-                : HLowpassKaiserBessel<int16_t>(width, opts->GetOutputSampleRate(), 51, 50).Calculate(), 51);
+                ? BoomaKaiserBesselDesigner::Lowpass(opts->GetOutputSampleRate() / 2, opts->GetOutputSampleRate(), 51, 50, false).data()
+                : BoomaKaiserBesselDesigner::Lowpass(width, opts->GetOutputSampleRate(), 51, 50, false).data(), 51);
         return true;
     }
 
@@ -495,8 +711,8 @@ bool BoomaInput::SetInputFilterWidth(ConfigOptions* opts, int width) {
     if( _inputFirFilter != nullptr ) {
         HLog("Setting new input filter width %d for real valued filter", width);
         _inputFirFilter->SetCoefficients(width == 0
-                ? HLowpassKaiserBessel<int16_t>(opts->GetOutputSampleRate() / 2, opts->GetOutputSampleRate(), 51, 50).Calculate()
-                : HBandpassKaiserBessel<int16_t>(_ifFrequency - (opts->GetInputFilterWidth() / 2), _ifFrequency + (opts->GetInputFilterWidth() / 2), opts->GetOutputSampleRate(), 51, 50).Calculate(),
+                ? BoomaKaiserBesselDesigner::Lowpass(opts->GetOutputSampleRate() / 2, opts->GetOutputSampleRate(), 51, 50, false).data()
+                : BoomaKaiserBesselDesigner::Bandpass(_ifFrequency - (opts->GetInputFilterWidth() / 2), _ifFrequency + (opts->GetInputFilterWidth() / 2), opts->GetOutputSampleRate(), 51, 50, false).data(),
                 51);
         return true;
     }
@@ -523,7 +739,7 @@ HWriterConsumer<int16_t>* BoomaInput::SetShift(ConfigOptions* opts, HWriterConsu
         // physical frequency that we want to capture. This avoids the LO injections that can be found many places
         // in the spectrum - a small prize for having such a powerful sdr at this low pricepoint.!
         HLog("Setting up IF multiplier for RTL-SDR device (shift %d)", 0 - opts->GetRtlsdrOffset() - (opts->GetRtlsdrCorrection() * opts->GetRtlsdrCorrectionFactor()));
-        _ifMultiplier = new HIqMultiplier<int16_t>("input_if_multiplier", previous, opts->GetOutputSampleRate(), 0 - opts->GetRtlsdrOffset() - opts->GetRtlsdrCorrection() * opts->GetRtlsdrCorrectionFactor(), 10, BLOCKSIZE);
+        _ifMultiplier = new BoomaIqMixer("input_if_multiplier", _profiler->Wrap("input_if_multiplier", previous), opts->GetOutputSampleRate(), 0 - opts->GetRtlsdrOffset() - opts->GetRtlsdrCorrection() * opts->GetRtlsdrCorrectionFactor(), opts->GetBlocksize());
 
         return _ifMultiplier->Consumer();
     }
@@ -533,7 +749,7 @@ HWriterConsumer<int16_t>* BoomaInput::SetShift(ConfigOptions* opts, HWriterConsu
 
 HWriterConsumer<int16_t>* BoomaInput::SetPreamp(ConfigOptions* opts, HWriterConsumer<int16_t>* previous) {
 
-    _preamp = new HGain<int16_t>("input_preamp_gain", previous, 1, BLOCKSIZE);
+    _preamp = new HGain<int16_t>("input_preamp_gain", _profiler->Wrap("input_preamp_gain", previous), 1, opts->GetBlocksize());
     _rfFftGain->SetGain(1);
 
     SetPreampLevel(opts, opts->GetPreamp());
@@ -567,18 +783,15 @@ bool BoomaInput::SetPreampLevel(ConfigOptions* opts, int level) {
     return true;
 }
 
-int BoomaInput::RfFftCallback(HFftResults* result, size_t length) {
-
-    // Store the current spectrum in the output buffer
-    memcpy((void*) _rfSpectrum, (void*) result->Spectrum, sizeof(double) * _rfFftSize / 2);
-    return length;
+int BoomaInput::GetRfSpectrum(double* spectrum, int size, unsigned long* sequence) {
+    _rfFftGate->Poll();
+    return _rfFft->GetSpectrum(spectrum, size, sequence);
 }
 
-int BoomaInput::GetRfSpectrum(double* spectrum) {
-    memcpy((void*) spectrum, _rfSpectrum, sizeof(double) * _rfSpectrumSize);
-    return _rfSpectrumSize;
+int BoomaInput::GetRfFftSize() {
+    return _rfFft->GetSize();
 }
 
-int BoomaInput::GetRfFftSize() {
-    return _rfFftSize;
+bool BoomaInput::SetRfSpectrum(int size, int overlap, int averaging) {
+    return _rfFft->Configure(size, overlap, averaging);
 }
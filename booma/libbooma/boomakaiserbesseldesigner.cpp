@@ -0,0 +1,167 @@
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+
+#include <hardtapi.h>
+
+#include "booma.h"
+#include "boomakaiserbesseldesigner.h"
+
+std::map<BoomaKaiserBesselDesigner::Key, BoomaKaiserBesselDesigner::Entry> BoomaKaiserBesselDesigner::_cache;
+std::list<BoomaKaiserBesselDesigner::Key> BoomaKaiserBesselDesigner::_used;
+std::set<BoomaKaiserBesselDesigner::Key> BoomaKaiserBesselDesigner::_stored;
+std::mutex BoomaKaiserBesselDesigner::_mutex;
+std::string BoomaKaiserBesselDesigner::_filename;
+
+std::vector<float> BoomaKaiserBesselDesigner::Lowpass(float cutoff, int rate, int taps, int attenuation, bool persist) {
+    return Get(std::make_tuple('L', cutoff, 0.0f, rate, taps, attenuation), persist);
+}
+
+std::vector<float> BoomaKaiserBesselDesigner::Bandpass(float low, float high, int rate, int taps, int attenuation, bool persist) {
+    return Get(std::make_tuple('B', low, high, rate, taps, attenuation), persist);
+}
+
+std::vector<float> BoomaKaiserBesselDesigner::Get(Key key, bool persist) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    std::map<Key, Entry>::iterator it = _cache.find(key);
+    if( it != _cache.end() ) {
+        _used.splice(_used.begin(), _used, it->second.used);
+        return it->second.coefficients;
+    }
+
+    char type;
+    float low;
+    float high;
+    int rate;
+    int taps;
+    int attenuation;
+    std::tie(type, low, high, rate, taps, attenuation) = key;
+
+    // The Hardt designers return a new array on every call
+    float* coefficients = type == 'L'
+        ? HLowpassKaiserBessel<int16_t>(low, rate, taps, attenuation).Calculate()
+        : HBandpassKaiserBessel<int16_t>(low, high, rate, taps, attenuation).Calculate();
+    std::vector<float> design(coefficients, coefficients + taps);
+    delete[] coefficients;
+
+    if( persist ) {
+        Store(key, design);
+    }
+    Insert(key, design);
+    return design;
+}
+
+void BoomaKaiserBesselDesigner::Insert(Key key, const std::vector<float>& coefficients) {
+
+    // Replace an existing design, else drop the least recently used design
+    std::map<Key, Entry>::iterator it = _cache.find(key);
+    if( it != _cache.end() ) {
+        _used.erase(it->second.used);
+        _cache.erase(it);
+    } else if( _cache.size() >= KAISERBESSEL_CACHE_SIZE ) {
+        _cache.erase(_used.back());
+        _used.pop_back();
+    }
+
+    _used.push_front(key);
+    Entry& entry = _cache[key];
+    entry.coefficients = coefficients;
+    entry.used = _used.begin();
+}
+
+void BoomaKaiserBesselDesigner::Store(Key key, const std::vector<float>& coefficients) {
+
+    // Large designs are faster to calculate than to read back
+    if( _filename.empty() || coefficients.size() > KAISERBESSEL_MAX_STORED_TAPS || !_stored.insert(key).second ) {
+        return;
+    }
+
+    std::ofstream file(_filename.c_str(), std::ios::app);
+    Write(file, key, coefficients);
+}
+
+void BoomaKaiserBesselDesigner::Write(std::ostream& file, Key key, const std::vector<float>& coefficients) {
+    file.precision(9);
+    file << std::get<0>(key) << " " << std::get<1>(key) << " " << std::get<2>(key) << " " << std::get<3>(key) << " " << std::get<4>(key) << " " << std::get<5>(key);
+    for( size_t i = 0; i < coefficients.size(); i++ ) {
+        file << " " << coefficients[i];
+    }
+    file << std::endl;
+}
+
+void BoomaKaiserBesselDesigner::SetPersistent(bool persistent) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    if( !persistent ) {
+        _filename = "";
+        return;
+    }
+
+    const char* home = std::getenv("HOME");
+    if( home == NULL ) {
+        HError("No HOME env. variable. Unable to store filter designs");
+        return;
+    }
+    std::string path(home);
+    path += "/.booma";
+    struct stat stats;
+    if( stat(path.c_str(), &stats) == -1 || !S_ISDIR(stats.st_mode) ) {
+        HError("No ~/.booma directory, unable to store filter designs");
+        return;
+    }
+    _filename = path + "/filters";
+    Load();
+}
+
+void BoomaKaiserBesselDesigner::Load() {
+    std::ifstream file(_filename.c_str());
+    std::string line;
+    std::set<Key> loaded;
+    int lines = 0;
+    while( std::getline(file, line) ) {
+        lines++;
+        std::istringstream values(line);
+        char type;
+        float low;
+        float high;
+        int rate;
+        int taps;
+        int attenuation;
+        if( !(values >> type >> low >> high >> rate >> taps >> attenuation) || taps <= 0 || taps > KAISERBESSEL_MAX_STORED_TAPS ) {
+            continue;
+        }
+        std::vector<float> coefficients(taps);
+        int i = 0;
+        while( i < taps && values >> coefficients[i] ) {
+            i++;
+        }
+
+        // Skip partially written lines
+        if( i == taps ) {
+            Key key = std::make_tuple(type, low, high, rate, taps, attenuation);
+            Insert(key, coefficients);
+            loaded.insert(key);
+        }
+    }
+    file.close();
+
+    // Keep the stored designs that are still cached, oldest first, so that the file
+    // never holds more than the cache plus the designs added during one run
+    _stored.clear();
+    for( std::list<Key>::reverse_iterator it = _used.rbegin(); it != _used.rend(); it++ ) {
+        if( loaded.count(*it) > 0 ) {
+            _stored.insert(*it);
+        }
+    }
+    if( lines != (int) _stored.size() ) {
+        std::ofstream compacted(_filename.c_str(), std::ios::trunc);
+        for( std::list<Key>::reverse_iterator it = _used.rbegin(); it != _used.rend(); it++ ) {
+            if( _stored.count(*it) > 0 ) {
+                Write(compacted, *it, _cache[*it].coefficients);
+            }
+        }
+    }
+    HLog("Read %d stored filter designs from %s", (int) _stored.size(), _filename.c_str());
+}
@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <cmath>
+#include <chrono>
+
+#include "boomalatency.h"
+#include "booma.h"
+
+// Number of input blocks and measurements kept
+#define LATENCY_HISTORY 4096
+
+BoomaCaptureReader::BoomaCaptureReader(std::string id, HReader<int16_t>* reader, BoomaLatency* latency, double valuesPerSecond):
+    HReader<int16_t>(id),
+    _reader(reader),
+    _latency(latency),
+    _valuesPerSecond(valuesPerSecond) {}
+
+int BoomaCaptureReader::Read(int16_t* dest, size_t blocksize) {
+    int read = _reader->Read(dest, blocksize);
+    if( read > 0 ) {
+        _latency->Captured(read / _valuesPerSecond);
+    }
+    return read;
+}
+
+BoomaLatencyProbe::BoomaLatencyProbe(std::string name, HWriterConsumer<int16_t>* consumer, BoomaLatency* latency, double valuesPerSecond):
+    HWriter<int16_t>(name + "_latency"),
+    _name(name),
+    _writer(nullptr),
+    _latency(latency),
+    _valuesPerSecond(valuesPerSecond),
+    _values(0),
+    _count(0),
+    _isReset(false),
+    _resetPosition(0) {
+
+    _latencies.reserve(LATENCY_HISTORY);
+    consumer->SetWriter(this);
+}
+
+int BoomaLatencyProbe::Write(int16_t* src, size_t blocksize) {
+
+    // Continue from a new stream position and drop measurements from before the jump
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if( _isReset ) {
+            _values = (unsigned long long) llround(_resetPosition * _valuesPerSecond);
+            _latencies.clear();
+            _isReset = false;
+        }
+    }
+
+    long long captured;
+    if( _latency->GetCaptureTime(_values / _valuesPerSecond, &captured) ) {
+        long long latency = BoomaLatency::Now() - captured;
+        std::lock_guard<std::mutex> lock(_mutex);
+        if( _latencies.size() < LATENCY_HISTORY ) {
+            _latencies.push_back(latency);
+        } else {
+            _latencies[_count % LATENCY_HISTORY] = latency;
+        }
+        _count++;
+    }
+    _values += blocksize;
+    return _writer->Write(src, blocksize);
+}
+
+LatencyStatistics BoomaLatencyProbe::GetStatistics() {
+    std::vector<long long> latencies;
+    LatencyStatistics statistics;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        latencies = _latencies;
+        statistics.Count = _count;
+    }
+    statistics.Name = _name;
+    statistics.Min = 0;
+    statistics.Avg = 0;
+    statistics.P99 = 0;
+    statistics.Max = 0;
+    if( latencies.empty() ) {
+        return statistics;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    double sum = 0;
+    for( std::vector<long long>::iterator it = latencies.begin(); it != latencies.end(); it++ ) {
+        sum += *it;
+    }
+    statistics.Min = latencies.front() / 1000.0;
+    statistics.Avg = sum / latencies.size() / 1000.0;
+    statistics.P99 = latencies[(latencies.size() * 99) / 100] / 1000.0;
+    statistics.Max = latencies.back() / 1000.0;
+    return statistics;
+}
+
+void BoomaLatencyProbe::Reset(double position) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _resetPosition = position;
+    _isReset = true;
+}
+
+BoomaLatency::BoomaLatency(bool enabled):
+    _enabled(enabled),
+    _reader(nullptr),
+    _captured(0),
+    _position(0) {}
+
+BoomaLatency::~BoomaLatency() {
+    for( std::vector<BoomaLatencyProbe*>::iterator it = _probes.begin(); it != _probes.end(); it++ ) {
+        delete (*it);
+    }
+    SAFE_DELETE(_reader);
+}
+
+long long BoomaLatency::Now() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+HReader<int16_t>* BoomaLatency::Capture(HReader<int16_t>* reader, double valuesPerSecond) {
+    if( !_enabled ) {
+        return reader;
+    }
+    _reader = new BoomaCaptureReader("input_capture", reader, this, valuesPerSecond);
+    return _reader->Reader();
+}
+
+HWriterConsumer<int16_t>* BoomaLatency::Probe(std::string name, HWriterConsumer<int16_t>* consumer, double valuesPerSecond) {
+    if( !_enabled ) {
+        return consumer;
+    }
+    BoomaLatencyProbe* probe = new BoomaLatencyProbe(name, consumer, this, valuesPerSecond);
+    _probes.push_back(probe);
+    return probe->Consumer();
+}
+
+void BoomaLatency::Captured(double seconds) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _position += seconds;
+    CaptureTime capture = { _position, Now() };
+    if( _captures.size() < LATENCY_HISTORY ) {
+        _captures.push_back(capture);
+    } else {
+        _captures[_captured % LATENCY_HISTORY] = capture;
+    }
+    _captured++;
+}
+
+bool BoomaLatency::GetCaptureTime(double position, long long* time) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if( _captures.empty() ) {
+        return false;
+    }
+
+    // Not captured yet, or captured in a block that is no longer in the history
+    size_t size = _captures.size();
+    size_t oldest = _captured > size ? _captured % size : 0;
+    if( position >= _captures[(_captured - 1) % size].End || (_captured > size && position < _captures[oldest].End) ) {
+        return false;
+    }
+
+    // First block ending after the position, the history is ordered by position
+    size_t low = 0;
+    size_t high = size - 1;
+    while( low < high ) {
+        size_t mid = (low + high) / 2;
+        if( _captures[(oldest + mid) % size].End > position ) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+    *time = _captures[(oldest + low) % size].Time;
+    return true;
+}
+
+void BoomaLatency::Reset(double position) {
+    HLog("Restarting latency probes at stream position %f", position);
+    for( std::vector<BoomaLatencyProbe*>::iterator it = _probes.begin(); it != _probes.end(); it++ ) {
+        (*it)->Reset(position);
+    }
+}
+
+std::vector<LatencyStatistics> BoomaLatency::GetStatistics() {
+    std::vector<LatencyStatistics> statistics;
+    for( std::vector<BoomaLatencyProbe*>::iterator it = _probes.begin(); it != _probes.end(); it++ ) {
+        statistics.push_back((*it)->GetStatistics());
+    }
+    return statistics;
+}
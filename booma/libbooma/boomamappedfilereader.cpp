@@ -0,0 +1,202 @@
+#include <cstring>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "boomamappedfilereader.h"
+#include "boomainputexception.h"
+
+BoomaMappedFileReader::BoomaMappedFileReader(std::string id, std::string filename, bool isWav, int rate, int channels, float speed, bool loop):
+    HReader<int16_t>(id),
+    _fd(-1),
+    _map(nullptr),
+    _mapSize(0),
+    _data(nullptr),
+    _length(0),
+    _rate(rate),
+    _channels(channels),
+    _position(0),
+    _seeked(true),
+    _speed(speed),
+    _loop(loop),
+    _played(0),
+    _startPlayed(0),
+    _startSpeed(speed) {
+
+    HLog("Mapping input file %s", filename.c_str());
+    _fd = open(filename.c_str(), O_RDONLY);
+    if( _fd < 0 ) {
+        HError("Unable to open input file %s", filename.c_str());
+        throw new BoomaInputException("Unable to open input file");
+    }
+    struct stat info;
+    if( fstat(_fd, &info) != 0 || info.st_size == 0 ) {
+        close(_fd);
+        HError("Input file %s is empty or can not be read", filename.c_str());
+        throw new BoomaInputException("Input file is empty or can not be read");
+    }
+    _mapSize = info.st_size;
+    void* map = mmap(nullptr, _mapSize, PROT_READ, MAP_PRIVATE, _fd, 0);
+    if( map == MAP_FAILED ) {
+        close(_fd);
+        HError("Unable to map input file %s", filename.c_str());
+        throw new BoomaInputException("Unable to map input file");
+    }
+    _map = (char*) map;
+    madvise(_map, _mapSize, MADV_SEQUENTIAL);
+
+    try {
+        if( isWav ) {
+            ParseWav(filename);
+        } else {
+            _data = (int16_t*) _map;
+            _length = _mapSize / sizeof(int16_t);
+        }
+    } catch( ... ) {
+        munmap(_map, _mapSize);
+        close(_fd);
+        throw;
+    }
+
+    // Only read whole frames, a file without any would never return from a looping read
+    _length -= _length % _channels;
+    if( _length == 0 ) {
+        munmap(_map, _mapSize);
+        close(_fd);
+        HError("Input file %s has no samples", filename.c_str());
+        throw new BoomaInputException("Input file has no samples");
+    }
+    HLog("Input file has %lu samples, %.1f seconds", _length, GetLength());
+}
+
+BoomaMappedFileReader::~BoomaMappedFileReader() {
+    if( _map != nullptr ) {
+        munmap(_map, _mapSize);
+    }
+    if( _fd >= 0 ) {
+        close(_fd);
+    }
+}
+
+void BoomaMappedFileReader::ParseWav(std::string filename) {
+
+    // RIFF header, then a list of chunks of which we need 'fmt ' and 'data'
+    if( _mapSize < 12 || memcmp(_map, "RIFF", 4) != 0 || memcmp(_map + 8, "WAVE", 4) != 0 ) {
+        HError("Input file %s is not a wav file", filename.c_str());
+        throw new BoomaInputException("Input file is not a wav file");
+    }
+    size_t offset = 12;
+    bool hasFormat = false;
+    while( offset + 8 <= _mapSize ) {
+        uint32_t size;
+        memcpy(&size, _map + offset + 4, sizeof(size));
+        if( memcmp(_map + offset, "fmt ", 4) == 0 && size >= 16 && offset + 8 + 16 <= _mapSize ) {
+            uint16_t format, channels, bits;
+            uint32_t rate;
+            memcpy(&format, _map + offset + 8, sizeof(format));
+            memcpy(&channels, _map + offset + 10, sizeof(channels));
+            memcpy(&rate, _map + offset + 12, sizeof(rate));
+            memcpy(&bits, _map + offset + 22, sizeof(bits));
+            if( format != 1 || bits != 16 ) {
+                HError("Input file %s is not 16 bit pcm", filename.c_str());
+                throw new BoomaInputException("Input file is not 16 bit pcm");
+            }
+            if( (int) rate != _rate || (int) channels != _channels ) {
+                HError("Input file %s has %d channels at %d, expected %d channels at %d", filename.c_str(), channels, rate, _channels, _rate);
+                throw new BoomaInputException("Input file has the wrong samplerate or number of channels");
+            }
+            hasFormat = true;
+        }
+        else if( memcmp(_map + offset, "data", 4) == 0 && hasFormat ) {
+            size_t available = _mapSize - (offset + 8);
+            _data = (int16_t*) (_map + offset + 8);
+            _length = (size < available ? size : available) / sizeof(int16_t);
+            return;
+        }
+        offset += 8 + size + (size & 1);
+    }
+    HError("Input file %s has no format or data chunk", filename.c_str());
+    throw new BoomaInputException("Input file has no format or data chunk");
+}
+
+int BoomaMappedFileReader::Read(int16_t* dest, size_t blocksize) {
+
+    // Load the position once, a seek while we are reading changes it
+    size_t expected = _position;
+    size_t position = expected;
+    if( position >= _length ) {
+        if( !_loop ) {
+            HLog("End of input file");
+            return 0;
+        }
+        position = 0;
+    }
+    Throttle();
+
+    // Copy, wrapping around if we are looping
+    size_t copied = 0;
+    while( copied < blocksize ) {
+        size_t count = std::min(blocksize - copied, _length - position);
+        memcpy((void*) &dest[copied], (void*) &_data[position], count * sizeof(int16_t));
+        copied += count;
+        position += count;
+        if( position == _length ) {
+            if( !_loop ) {
+                break;
+            }
+            position = 0;
+        }
+    }
+
+    // Do not overwrite a seek done while we were reading
+    _position.compare_exchange_strong(expected, position);
+    _played += copied;
+    return copied;
+}
+
+void BoomaMappedFileReader::Throttle() {
+
+    // Restart the playback clock after a seek or a new speed
+    float speed = _speed;
+    if( _seeked.exchange(false) || speed != _startSpeed ) {
+        _start = std::chrono::steady_clock::now();
+        _startPlayed = _played;
+        _startSpeed = speed;
+        return;
+    }
+    if( speed <= 0 ) {
+        return;
+    }
+
+    // Wait until the block is due
+    double due = (double) (_played - _startPlayed) / ((double) _rate * _channels * speed);
+    std::chrono::steady_clock::time_point at = _start + std::chrono::microseconds((long long) (due * 1000000));
+    std::this_thread::sleep_until(at);
+}
+
+bool BoomaMappedFileReader::Seek(double seconds) {
+    if( seconds < 0 || seconds > GetLength() ) {
+        HError("Seek to %f is outside the input file (%f seconds)", seconds, GetLength());
+        return false;
+    }
+    size_t position = (size_t) (seconds * _rate) * _channels;
+    _position = position < _length ? position : _length;
+    _seeked = true;
+    HLog("Input file position set to %f seconds", seconds);
+    return true;
+}
+
+double BoomaMappedFileReader::GetPosition() {
+    return (double) (_position / _channels) / _rate;
+}
+
+double BoomaMappedFileReader::GetLength() {
+    return (double) (_length / _channels) / _rate;
+}
+
+void BoomaMappedFileReader::SetSpeed(float speed) {
+    HLog("Input file speed set to %f", speed);
+    _speed = speed < 0 ? 0 : speed;
+}
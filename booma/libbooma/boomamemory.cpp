@@ -0,0 +1,138 @@
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <sys/mman.h>
+
+#include <hardtapi.h>
+
+#include "boomamemory.h"
+
+std::mutex BoomaMemory::_mutex;
+char* BoomaMemory::_pool = nullptr;
+size_t BoomaMemory::_poolSize = 0;
+size_t BoomaMemory::_poolUsed = 0;
+bool BoomaMemory::_isLocked = false;
+bool BoomaMemory::_isExhausted = false;
+std::map<size_t, std::vector<char*>> BoomaMemory::_free;
+size_t BoomaMemory::_inUse = 0;
+size_t BoomaMemory::_peak = 0;
+
+// Each buffer is preceded by one cache line holding its (rounded) size
+static const size_t HeaderSize = BoomaMemory::Alignment;
+
+bool BoomaMemory::Reserve(size_t bytes, bool hugePages, bool lock) {
+    std::lock_guard<std::mutex> guard(_mutex);
+
+    if( _pool != nullptr ) {
+        HError("Memory pool of %lu bytes already reserved", _poolSize);
+        return false;
+    }
+
+    // Explicit huge pages first, falling back to normal pages (where the kernel
+    // may still use transparent huge pages)
+    void* pool = MAP_FAILED;
+    size_t size = bytes;
+#ifdef MAP_HUGETLB
+    if( hugePages ) {
+        size = ((bytes + (2 << 20) - 1) >> 21) << 21;
+        pool = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if( pool == MAP_FAILED ) {
+            HLog("No huge pages available for the memory pool, using normal pages");
+        }
+    }
+#endif
+    if( pool == MAP_FAILED ) {
+        size = bytes;
+        pool = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if( pool == MAP_FAILED ) {
+            HError("Unable to map a memory pool of %lu bytes", bytes);
+            return false;
+        }
+#ifdef MADV_HUGEPAGE
+        if( hugePages ) {
+            madvise(pool, size, MADV_HUGEPAGE);
+        }
+#endif
+    }
+
+    // Touch all pages now rather than on first use in the audio path
+    memset(pool, 0, size);
+    if( lock ) {
+        if( mlock(pool, size) == 0 ) {
+            _isLocked = true;
+        } else {
+            HError("Unable to lock the memory pool in memory (check 'ulimit -l')");
+        }
+    }
+
+    _pool = (char*) pool;
+    _poolSize = size;
+    _poolUsed = 0;
+    _isExhausted = false;
+    HLog("Reserved memory pool of %lu bytes (%s)", _poolSize, _isLocked ? "locked" : "not locked");
+    return true;
+}
+
+void* BoomaMemory::Allocate(size_t bytes) {
+    std::lock_guard<std::mutex> guard(_mutex);
+
+    size_t size = ((bytes + Alignment - 1) / Alignment) * Alignment;
+    if( size == 0 ) {
+        size = Alignment;
+    }
+
+    // Reuse a freed buffer of the same size
+    char* buffer = nullptr;
+    std::map<size_t, std::vector<char*>>::iterator it = _free.find(size);
+    if( it != _free.end() && !it->second.empty() ) {
+        buffer = it->second.back();
+        it->second.pop_back();
+    }
+
+    // Carve a new buffer from the pool
+    else if( _pool != nullptr && _poolUsed + HeaderSize + size <= _poolSize ) {
+        buffer = _pool + _poolUsed + HeaderSize;
+        _poolUsed += HeaderSize + size;
+    }
+
+    // Or from the heap
+    else {
+        if( _pool != nullptr && !_isExhausted ) {
+            HError("Memory pool of %lu bytes exhausted, using the heap. Increase the pool size", _poolSize);
+            _isExhausted = true;
+        }
+        void* allocated;
+        if( posix_memalign(&allocated, Alignment, HeaderSize + size) != 0 ) {
+            HError("Unable to allocate %lu bytes", size);
+            throw std::bad_alloc();
+        }
+        buffer = (char*) allocated + HeaderSize;
+    }
+
+    *((size_t*) (buffer - HeaderSize)) = size;
+    _inUse += size;
+    _peak = _inUse > _peak ? _inUse : _peak;
+    return (void*) buffer;
+}
+
+void BoomaMemory::Free(void* buffer) {
+    if( buffer == nullptr ) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(_mutex);
+
+    // Buffers are never given back to the heap, they are kept for the next chain
+    size_t size = *((size_t*) ((char*) buffer - HeaderSize));
+    _free[size].push_back((char*) buffer);
+    _inUse -= size;
+}
+
+size_t BoomaMemory::GetInUse() {
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _inUse;
+}
+
+size_t BoomaMemory::GetPeak() {
+    std::lock_guard<std::mutex> guard(_mutex);
+    return _peak;
+}
@@ -0,0 +1,106 @@
+#include <cmath>
+
+#include "boomamixer.h"
+#include "boomamemory.h"
+
+static inline int16_t Saturate(float value) {
+    return value > 32767 ? 32767 : (value < -32768 ? -32768 : (int16_t) lrintf(value));
+}
+
+BoomaMixer::BoomaMixer(std::string id, HWriterConsumer<int16_t>* consumer, int rate, float frequency, size_t blocksize):
+    HFilter<int16_t>(id, consumer, blocksize) {
+
+    Init(rate, frequency, blocksize);
+}
+
+BoomaMixer::BoomaMixer(std::string id, HWriter<int16_t>* writer, int rate, float frequency, size_t blocksize):
+    HFilter<int16_t>(id, writer, blocksize) {
+
+    Init(rate, frequency, blocksize);
+}
+
+BoomaMixer::~BoomaMixer() {
+    delete _nco;
+    BoomaFree(_cos);
+}
+
+void BoomaMixer::Init(int rate, float frequency, size_t blocksize) {
+    HLog("Creating mixer at %f Hz", frequency);
+    _nco = new BoomaNco(rate, frequency);
+    _cos = BoomaAllocate<float>(blocksize);
+}
+
+void BoomaMixer::Filter(int16_t* src, int16_t* dest, size_t blocksize) {
+    _nco->Generate(_cos, nullptr, blocksize);
+    for( size_t i = 0; i < blocksize; i++ ) {
+        dest[i] = Saturate(src[i] * _cos[i]);
+    }
+}
+
+BoomaIqMixer::BoomaIqMixer(std::string id, HWriterConsumer<int16_t>* consumer, int rate, float frequency, size_t blocksize):
+    HFilter<int16_t>(id, consumer, blocksize) {
+
+    Init(rate, frequency, blocksize);
+}
+
+BoomaIqMixer::BoomaIqMixer(std::string id, HWriter<int16_t>* writer, int rate, float frequency, size_t blocksize):
+    HFilter<int16_t>(id, writer, blocksize) {
+
+    Init(rate, frequency, blocksize);
+}
+
+BoomaIqMixer::~BoomaIqMixer() {
+    delete _nco;
+    BoomaFree(_cos);
+    BoomaFree(_sin);
+}
+
+void BoomaIqMixer::Init(int rate, float frequency, size_t blocksize) {
+    HLog("Creating iq mixer at %f Hz", frequency);
+    _nco = new BoomaNco(rate, frequency);
+    _cos = BoomaAllocate<float>(blocksize / 2);
+    _sin = BoomaAllocate<float>(blocksize / 2);
+}
+
+void BoomaIqMixer::Filter(int16_t* src, int16_t* dest, size_t blocksize) {
+    size_t samples = blocksize / 2;
+    _nco->Generate(_cos, _sin, samples);
+
+    // (I + jQ)(cos + j sin)
+    for( size_t i = 0; i < samples; i++ ) {
+        float re = src[2 * i];
+        float im = src[2 * i + 1];
+        dest[2 * i] = Saturate(re * _cos[i] - im * _sin[i]);
+        dest[2 * i + 1] = Saturate(re * _sin[i] + im * _cos[i]);
+    }
+}
+
+BoomaToneGenerator::BoomaToneGenerator(std::string id, int rate, float frequency, int amplitude, size_t blocksize):
+    HReader<int16_t>(id),
+    _blocksize(blocksize),
+    _amplitude(amplitude) {
+
+    HLog("Creating tone generator at %f Hz", frequency);
+    _nco = new BoomaNco(rate, frequency);
+    _cos = BoomaAllocate<float>(blocksize);
+}
+
+BoomaToneGenerator::~BoomaToneGenerator() {
+    delete _nco;
+    BoomaFree(_cos);
+}
+
+int BoomaToneGenerator::Read(int16_t* dest, size_t blocksize) {
+
+    // Readers further down may ask for larger blocks than the chain blocksize
+    if( blocksize > _blocksize ) {
+        BoomaFree(_cos);
+        _cos = BoomaAllocate<float>(blocksize);
+        _blocksize = blocksize;
+    }
+    _nco->Generate(_cos, nullptr, blocksize);
+    for( size_t i = 0; i < blocksize; i++ ) {
+        dest[i] = Saturate(_amplitude * _cos[i]);
+    }
+    return blocksize;
+}
@@ -0,0 +1,78 @@
+#include <cmath>
+
+#include <hardtapi.h>
+
+#include "boomanco.h"
+
+std::map<int, std::vector<float>> BoomaNco::_tables;
+std::mutex BoomaNco::_mutex;
+
+// Four phases, advanced together by the compiler's vector unit
+typedef uint32_t BoomaPhase4 __attribute__((vector_size(16)));
+
+BoomaNco::BoomaNco(int rate, float frequency, float sfdr):
+    _rate(rate),
+    _phase(0) {
+
+    _bits = GetTableBits(sfdr);
+
+    // Sine table with a quarter period extra at the end so that cos(x) = table[x + N/4]
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::map<int, std::vector<float>>::iterator it = _tables.find(_bits);
+    if( it == _tables.end() ) {
+        int size = 1 << _bits;
+        HLog("Creating oscillator table with %d entries", size);
+        std::vector<float> table(size + size / 4);
+        for( int i = 0; i < size + size / 4; i++ ) {
+            table[i] = sin(2 * M_PI * i / size);
+        }
+        it = _tables.insert(std::make_pair(_bits, table)).first;
+    }
+    _table = it->second.data();
+
+    SetFrequency(frequency);
+}
+
+int BoomaNco::GetTableBits(float sfdr) {
+    int bits = (int) ceil(sfdr / 6.02);
+    return bits < 8 ? 8 : (bits > 20 ? 20 : bits);
+}
+
+void BoomaNco::SetFrequency(float frequency) {
+    _frequency = frequency;
+
+    // Negative frequencies wrap around to a phase decrement
+    _increment = (uint32_t) (int64_t) llround((double) frequency / _rate * 4294967296.0);
+}
+
+void BoomaNco::Generate(float* cos, float* sin, size_t count) {
+    int shift = 32 - _bits;
+    int quarter = 1 << (_bits - 2);
+
+    BoomaPhase4 phases = {_phase, _phase + _increment, _phase + 2 * _increment, _phase + 3 * _increment};
+    BoomaPhase4 step = {4 * _increment, 4 * _increment, 4 * _increment, 4 * _increment};
+
+    size_t i = 0;
+    for( ; i + 4 <= count; i += 4 ) {
+        BoomaPhase4 index = phases >> shift;
+        for( int j = 0; j < 4; j++ ) {
+            cos[i + j] = _table[index[j] + quarter];
+        }
+        if( sin != nullptr ) {
+            for( int j = 0; j < 4; j++ ) {
+                sin[i + j] = _table[index[j]];
+            }
+        }
+        phases += step;
+    }
+    _phase = phases[0];
+
+    for( ; i < count; i++ ) {
+        uint32_t index = _phase >> shift;
+        cos[i] = _table[index + quarter];
+        if( sin != nullptr ) {
+            sin[i] = _table[index];
+        }
+        _phase += _increment;
+    }
+}
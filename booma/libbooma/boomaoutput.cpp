@@ -1,6 +1,7 @@
 #include "boomaoutput.h"
+#include "boomakaiserbesseldesigner.h"
 
-BoomaOutput::BoomaOutput(ConfigOptions* opts, BoomaReceiver* receiver):
+BoomaOutput::BoomaOutput(ConfigOptions* opts, BoomaReceiver* receiver, BoomaLatency* latency):
         _outputVolume(nullptr),
         _outputFilter(nullptr),
         _soundcardMultiplexer(nullptr),
@@ -12,60 +13,78 @@ BoomaOutput::BoomaOutput(ConfigOptions* opts, BoomaReceiver* receiver):
         _audioSplitter(nullptr),
         _audioBreaker(nullptr),
         _audioBuffer(nullptr),
+        _audioDelay(nullptr),
+        _trigger(nullptr),
         _frequencyAlignmentGenerator(nullptr),
         _frequencyAlignmentMixer(nullptr),
         _ifSplitter(nullptr),
         _signalLevel(nullptr),
         _signalLevelWriter(nullptr),
+        _blocksize(opts->GetBlocksize()),
         _outputFilterWidth(receiver->GetOutputFilterWidth()),
+        _audioFftGate(nullptr),
         _audioFft(nullptr),
-        _audioFftWindow(nullptr),
-        _audioFftWriter(nullptr),
-        _audioSpectrum(nullptr),
-        _audioFftSize(256),
-        _audioFftGain(nullptr) {
+        _audioFftGain(nullptr),
+        _profiler(nullptr) {
 
-    // AF fft spectrum output
-    _audioSpectrumSize = _audioFftSize / 2;
-    _audioSpectrum = new double[_audioSpectrumSize];
-    memset((void*) _audioSpectrum, 0, sizeof(double) * _audioSpectrumSize);
+    // Stage profiling (does nothing unless enabled)
+    _profiler = new BoomaProfiler(opts->GetEnableProfiling());
+
+    // Measure the latency through the receiver and the output (if enabled)
+    HWriterConsumer<int16_t>* source = receiver->GetLastWriterConsumer();
+    if( latency != nullptr ) {
+        source = latency->Probe("receiver", source, opts->GetOutputSampleRate());
+    }
 
     // Final output filter to remove high frequencies
-    _outputFilter = new HFirFilter<int16_t>("output_high_frequence_fir", receiver->GetLastWriterConsumer(), HLowpassKaiserBessel<int16_t>(_outputFilterWidth, opts->GetOutputSampleRate(), 15, 90).Calculate(), 15, BLOCKSIZE);
+    _outputFilter = new BoomaFirFilter("output_high_frequence_fir", _profiler->Wrap("output_high_frequence_fir", source), BoomaKaiserBesselDesigner::Lowpass(_outputFilterWidth, opts->GetOutputSampleRate(), 15, 90).data(), 15, opts->GetBlocksize(), false, opts->GetFastConvolutionThreshold());
 
     // Setup a splitter to split off audio dump
     HLog("Setting up output audio splitter");
-    _audioSplitter = new HSplitter<int16_t>("output_audio_splitter", _outputFilter->Consumer());
-    _audioDelay = new HDelay<int16_t>("output_audio_delay", _audioSplitter->Consumer(), BLOCKSIZE, opts->GetOutputSampleRate(), 10);
-    _audioBreaker = new HBreaker<int16_t>("output_audio_breaker", _audioDelay->Consumer(), !opts->GetDumpAudio(), BLOCKSIZE);
-    _audioBuffer = new HBufferedWriter<int16_t>("output_audio_buffer", _audioBreaker->Consumer(), BLOCKSIZE, opts->GetReservedBuffers(), opts->GetEnableBuffers());
+    _audioSplitter = new BoomaSplitter("output_audio_splitter", _profiler->Wrap("output_audio_splitter", _outputFilter->Consumer()), opts->GetBlocksize());
+    _audioDelay = new BoomaDelay("output_audio_delay", _audioSplitter, opts->GetBlocksize(), opts->GetOutputSampleRate(), opts->GetDumpPreroll());
+    _audioBreaker = new HBreaker<int16_t>("output_audio_breaker", _audioDelay->Consumer(), !opts->GetDumpAudio(), opts->GetBlocksize());
+    _audioBuffer = new HBufferedWriter<int16_t>("output_audio_buffer", _profiler->Wrap("output_audio_buffer", _audioBreaker->Consumer()), opts->GetBlocksize(), opts->GetReservedBuffers(), opts->GetEnableBuffers());
     std::string dumpfile = "OUTPUT_" + (opts->GetDumpFileSuffix() == "" ? std::to_string(std::time(nullptr)) : opts->GetDumpFileSuffix());
-    if( opts->GetDumpAudioFileFormat() == WAV ) {
+    if( opts->GetDumpThreadBlocks() > 0 ) {
+        _audioWriter = new BoomaDumpWriter("output_audio_dump_writer", dumpfile, opts->GetDumpAudioFileFormat() == WAV, _audioBuffer->Consumer(), opts->GetOutputSampleRate(), 1,
+                                           opts->GetBlocksize(), opts->GetDumpThreadBlocks(), opts->GetDumpRotateSize(), opts->GetDumpRotateDuration());
+    } else if( opts->GetDumpAudioFileFormat() == WAV ) {
         _audioWriter = new HWavWriter<int16_t>("output_audio_wav_writer", (dumpfile + ".wav").c_str(), H_SAMPLE_FORMAT_INT_16, 1, opts->GetOutputSampleRate(), _audioBuffer->Consumer(), true);
     } else {
         _audioWriter = new HFileWriter<int16_t>("output_audio_pcm_writer", (dumpfile + ".pcm").c_str(), _audioBuffer->Consumer(), true);
     }
 
-    // Add signallevel measurement just before the volume
+    // Let the signal level start and stop dumps
+    if( opts->GetTriggerLevel() >= 0 ) {
+        _trigger = new BoomaTrigger(opts->GetTriggerLevel(), opts->GetTriggerHold(), opts->GetDumpPreroll());
+        _trigger->Arm(_audioBreaker, opts->GetDumpAudio());
+    }
+
+    // Add signallevel measurement just before the volume, averaging over the same time for any blocksize
     HLog("Setting up signallevel measurement");
-    _signalLevel = new HSignalLevelOutput<int16_t>("output_signal_level_splitter", _audioSplitter->Consumer(), SIGNALLEVEL_AVERAGING_COUNT, 54, 16);
+    _signalLevel = new HSignalLevelOutput<int16_t>("output_signal_level_splitter", _profiler->Wrap("output_signal_level_splitter", _audioSplitter->Consumer()), SIGNALLEVEL_AVERAGING_COUNT * BLOCKSIZE / opts->GetBlocksize(), 54, 16);
     _signalLevelWriter = HCustomWriter<HSignalLevelResult>::Create<BoomaOutput>("output_signal_level_writer", this, &BoomaOutput::SignalLevelCallback, _signalLevel->Consumer());
 
-    // Add audio spectrum calculation
-    _audioFftGain = new HAgc<int16_t>("output_spectrum_gain", _audioSplitter->Consumer(), opts->GetAfFftAgcLevel(), 3,  BLOCKSIZE);
-    _audioFftWindow = new HHammingWindow<int16_t>();
-    _audioFft = new HFftOutput<int16_t>("output_spectrum_fft_output", _audioFftSize, AUDIOFFT_AVERAGING_COUNT, AUDIOFFT_SKIP, _audioFftGain->Consumer(), _audioFftWindow, opts->GetOutputSampleRate(), 4, opts->GetOutputSampleRate() / 16);
-    _audioFftWriter = HCustomWriter<HFftResults>::Create<BoomaOutput>("output_spectrum_writer", this, &BoomaOutput::AudioFftCallback, _audioFft->Consumer());
+    // Add audio spectrum calculation, only running while someone reads the spectrum
+    _audioFftGate = new BoomaDemandGate("output_spectrum_gate", _audioSplitter->Consumer(), opts->GetSpectrumTimeout());
+    _audioFftGain = new HAgc<int16_t>("output_spectrum_gain", _profiler->Wrap("output_spectrum_gain", _audioFftGate->Consumer()), opts->GetAfFftAgcLevel(), 3,  opts->GetBlocksize());
+    _audioFft = new BoomaSpectrum("output_spectrum_fft_output", _profiler->Wrap("output_spectrum_fft_output", _audioFftGain->Consumer()), opts->GetOutputSampleRate(), false, HAMMING_WINDOW, 4, opts->GetAfFftSize(), opts->GetAfFftOverlap(), opts->GetAfFftAveraging());
 
     // Add volume control
     HLog("Output volume");
-    _outputVolume = new HGain<int16_t>("output_volume_control", _audioSplitter->Consumer(), opts->GetVolume(), BLOCKSIZE);
+    _outputVolume = new HGain<int16_t>("output_volume_control", _profiler->Wrap("output_volume_control", _audioSplitter->Consumer()), opts->GetVolume(), opts->GetBlocksize());
 
     // Enable frequency alignment ?
     if( opts->GetFrequencyAlign() ) {
         HLog("Enabling ftl-sdr frequency alignment mode");
-        _frequencyAlignmentGenerator = new HSineGenerator<int16_t>("output_frequency_alignment_generator", opts->GetOutputSampleRate(), 800, opts->GetFrequencyAlignVolume());
-        _frequencyAlignmentMixer = new HLinearMixer<int16_t>("output_frequency_alignment_mixer", _frequencyAlignmentGenerator->Reader(), _outputVolume->Consumer(), BLOCKSIZE);
+        _frequencyAlignmentGenerator = new BoomaToneGenerator("output_frequency_alignment_generator", opts->GetOutputSampleRate(), 800, opts->GetFrequencyAlignVolume(), opts->GetBlocksize());
+        _frequencyAlignmentMixer = new HLinearMixer<int16_t>("output_frequency_alignment_mixer", _frequencyAlignmentGenerator->Reader(), _profiler->Wrap("output_frequency_alignment_mixer", _outputVolume->Consumer()), opts->GetBlocksize());
+    }
+
+    HWriterConsumer<int16_t>* audio = GetOutputVolumeConsumer();
+    if( latency != nullptr ) {
+        audio = latency->Probe("output", audio, opts->GetOutputSampleRate());
     }
 
     // Select output device
@@ -73,11 +92,11 @@ BoomaOutput::BoomaOutput(ConfigOptions* opts, BoomaReceiver* receiver):
         HLog("Writing output audio to %s", opts->GetOutputFilename().c_str());
         if( IsWav(opts->GetOutputFilename()) ) {
             HLog("Creating output wav file");
-            _wavWriter = new HWavWriter<int16_t>("output_audio_wav_writer", opts->GetOutputFilename().c_str(), H_SAMPLE_FORMAT_INT_16, 1, opts->GetOutputSampleRate(), GetOutputVolumeConsumer());
+            _wavWriter = new HWavWriter<int16_t>("output_audio_wav_writer", opts->GetOutputFilename().c_str(), H_SAMPLE_FORMAT_INT_16, 1, opts->GetOutputSampleRate(), _profiler->Wrap("output_audio_wav_writer", audio));
             _pcmWriter = nullptr;
         } else {
             HLog("Creating output pcm file");
-            _pcmWriter = new HFileWriter<int16_t>("output_audio_pcm_writer", opts->GetOutputFilename().c_str(), GetOutputVolumeConsumer());
+            _pcmWriter = new HFileWriter<int16_t>("output_audio_pcm_writer", opts->GetOutputFilename().c_str(), _profiler->Wrap("output_audio_pcm_writer", audio));
             _wavWriter = nullptr;
         }
         _soundcardWriter = nullptr;
@@ -85,7 +104,7 @@ BoomaOutput::BoomaOutput(ConfigOptions* opts, BoomaReceiver* receiver):
     }
     else if( opts->GetOutputAudioDevice() == -1 ) {
         HLog("Writing output audio to /dev/null device");
-        _nullWriter = new HNullWriter<int16_t>("output_null_writer", GetOutputVolumeConsumer());
+        _nullWriter = new HNullWriter<int16_t>("output_null_writer", _profiler->Wrap("output_null_writer", audio));
         _soundcardWriter = nullptr;
         _pcmWriter = nullptr;
         _wavWriter = nullptr;
@@ -94,11 +113,11 @@ BoomaOutput::BoomaOutput(ConfigOptions* opts, BoomaReceiver* receiver):
     {
         HLog("Initializing multiplexer for 2-channel mono output");
         std::vector<HWriterConsumer<int16_t>*> consumers;
-        consumers.push_back(GetOutputVolumeConsumer());
-        _soundcardMultiplexer = new HMux<int16_t>("output_multiplexer", consumers, BLOCKSIZE, true);
+        consumers.push_back(_profiler->Wrap("output_multiplexer", audio));
+        _soundcardMultiplexer = new HMux<int16_t>("output_multiplexer", consumers, opts->GetBlocksize(), true);
 
         HLog("Initializing audio output device %d", opts->GetOutputAudioDevice());
-        _soundcardWriter = new HSoundcardWriter<int16_t>("output_audio_card_writer", opts->GetOutputAudioDevice(), opts->GetOutputSampleRate(), 2, H_SAMPLE_FORMAT_INT_16, BLOCKSIZE, _soundcardMultiplexer->Consumer());
+        _soundcardWriter = new HSoundcardWriter<int16_t>("output_audio_card_writer", opts->GetOutputAudioDevice(), opts->GetOutputSampleRate(), 2, H_SAMPLE_FORMAT_INT_16, opts->GetBlocksize(), _soundcardMultiplexer->Consumer());
         _nullWriter = nullptr;
         _pcmWriter = nullptr;
         _wavWriter = nullptr;
@@ -117,6 +136,8 @@ BoomaOutput::~BoomaOutput() {
     SAFE_DELETE(_audioWriter);
     SAFE_DELETE(_audioSplitter);
     SAFE_DELETE(_audioBreaker);
+    SAFE_DELETE(_audioDelay);
+    SAFE_DELETE(_trigger);
     SAFE_DELETE(_audioBuffer);
     SAFE_DELETE(_frequencyAlignmentGenerator);
     SAFE_DELETE(_frequencyAlignmentMixer);
@@ -124,17 +145,25 @@ BoomaOutput::~BoomaOutput() {
     SAFE_DELETE(_signalLevel);
     SAFE_DELETE(_signalLevelWriter);
     SAFE_DELETE(_audioFft);
-    SAFE_DELETE(_audioFftWriter);
-    SAFE_DELETE(_audioFftWindow);
-    SAFE_DELETE(_audioSpectrum);
+    SAFE_DELETE(_audioFftGate);
     SAFE_DELETE(_audioFftGain);
+
+    SAFE_DELETE(_profiler);
 }
 
 bool BoomaOutput::SetDumpAudio(bool enabled) {
+    if( _trigger != nullptr ) {
+        return _trigger->Arm(_audioBreaker, enabled);
+    }
     _audioBreaker->SetOff(!enabled);
     return !_audioBreaker->GetOff();
 }
 
+unsigned long BoomaOutput::GetDroppedDumpBlocks() {
+    BoomaDumpWriter* writer = dynamic_cast<BoomaDumpWriter*>(_audioWriter);
+    return writer != nullptr ? writer->GetDroppedBlocks() : 0;
+}
+
 int BoomaOutput::SetVolume(int volume) {
     if( volume > 100 || volume < 0 ) {
         return false;
@@ -164,9 +193,12 @@ int BoomaOutput::SignalLevelCallback(HSignalLevelResult* result, size_t length)
     // Store the current level
     _signalStrength = result->S;
     _signalMax = result->Max;
+    if( _trigger != nullptr ) {
+        _trigger->Update(_signalStrength);
+    }
 
     // Store the signal sum, scaled
-    _signalSum = (int) (result->Sum / BLOCKSIZE);
+    _signalSum = (int) (result->Sum / _blocksize);
     return length;
 }
 
@@ -182,18 +214,15 @@ int BoomaOutput::GetSignalMax() {
     return _signalMax;
 }
 
-int BoomaOutput::AudioFftCallback(HFftResults* result, size_t length) {
-
-    // Store the current spectrum in the output buffer
-    memcpy((void*) _audioSpectrum, (void*) result->Spectrum, sizeof(double) * _audioFftSize / 2);
-    return length;
+int BoomaOutput::GetAudioFftSize() {
+    return _audioFft->GetSize();
 }
 
-int BoomaOutput::GetAudioFftSize() {
-    return _audioFftSize;
+int BoomaOutput::GetAudioSpectrum(double* spectrum, int size, unsigned long* sequence) {
+    _audioFftGate->Poll();
+    return _audioFft->GetSpectrum(spectrum, size, sequence);
 }
 
-int BoomaOutput::GetAudioSpectrum(double* spectrum) {
-    memcpy((void*) spectrum, _audioSpectrum, sizeof(double) * _audioSpectrumSize);
-    return _audioSpectrumSize;
+bool BoomaOutput::SetAudioSpectrum(int size, int overlap, int averaging) {
+    return _audioFft->Configure(size, overlap, averaging);
 }
@@ -0,0 +1,101 @@
+#include "boomapolyphasedecimator.h"
+#include "boomamemory.h"
+
+BoomaPolyphaseDecimator::BoomaPolyphaseDecimator(std::string id, HReader<int16_t>* reader, int factor, float* coefficients, int taps, size_t blocksize, bool isIq):
+    HReader<int16_t>(id),
+    _reader(reader),
+    _factor(factor),
+    _taps(taps),
+    _blocksize(blocksize),
+    _channels(isIq ? 2 : 1) {
+
+    HLog("Creating polyphase decimator with factor %d and %d taps for %s samples", _factor, _taps, isIq ? "IQ" : "real");
+
+    _coefficients = BoomaAllocate<float>(_taps);
+    for( int i = 0; i < _taps; i++ ) {
+        _coefficients[i] = coefficients[_taps - 1 - i];
+    }
+
+    // Each read consumes 'factor' input blocks
+    _input = BoomaAllocate<int16_t>(_factor * _blocksize);
+
+    // Sample windows, 'taps - 1' samples of history followed by the new samples
+    _windowLength = (_taps - 1) + (_factor * _blocksize) / _channels;
+    _windows = new float*[_channels];
+    for( int ch = 0; ch < _channels; ch++ ) {
+        _windows[ch] = BoomaAllocate<float>(_windowLength);
+        memset((void*) _windows[ch], 0, sizeof(float) * _windowLength);
+    }
+}
+
+BoomaPolyphaseDecimator::~BoomaPolyphaseDecimator() {
+    BoomaFree(_coefficients);
+    BoomaFree(_input);
+    for( int ch = 0; ch < _channels; ch++ ) {
+        BoomaFree(_windows[ch]);
+    }
+    delete[] _windows;
+}
+
+float BoomaPolyphaseDecimator::Dot(float* coefficients, float* samples, int taps) {
+
+    // Four independent sums lets the compiler vectorize and pipeline the loop
+    float a0 = 0;
+    float a1 = 0;
+    float a2 = 0;
+    float a3 = 0;
+    int i = 0;
+    for( ; i + 3 < taps; i += 4 ) {
+        a0 += coefficients[i] * samples[i];
+        a1 += coefficients[i + 1] * samples[i + 1];
+        a2 += coefficients[i + 2] * samples[i + 2];
+        a3 += coefficients[i + 3] * samples[i + 3];
+    }
+    for( ; i < taps; i++ ) {
+        a0 += coefficients[i] * samples[i];
+    }
+    return (a0 + a1) + (a2 + a3);
+}
+
+int BoomaPolyphaseDecimator::Read(int16_t* dest, size_t blocksize) {
+
+    if( blocksize != _blocksize ) {
+        HError("Requested blocksize %d differs from the decimator blocksize %d", blocksize, _blocksize);
+        return 0;
+    }
+
+    // Get 'factor' blocks from upstream
+    for( int block = 0; block < _factor; block++ ) {
+        int read = _reader->Read(&_input[block * _blocksize], _blocksize);
+        if( read != (int) _blocksize ) {
+            HLog("Upstream reader returned %d, expected %d", read, _blocksize);
+            return 0;
+        }
+    }
+
+    // Append the new samples to the channel windows
+    int newSamples = (_factor * _blocksize) / _channels;
+    for( int ch = 0; ch < _channels; ch++ ) {
+        float* window = &_windows[ch][_taps - 1];
+        int16_t* src = &_input[ch];
+        for( int i = 0; i < newSamples; i++ ) {
+            window[i] = src[i * _channels];
+        }
+    }
+
+    // Calculate the kept samples only
+    int outputs = _blocksize / _channels;
+    for( int n = 0; n < outputs; n++ ) {
+        for( int ch = 0; ch < _channels; ch++ ) {
+            float value = Dot(_coefficients, &_windows[ch][n * _factor], _taps);
+            dest[n * _channels + ch] = value > 32767 ? 32767 : (value < -32768 ? -32768 : (int16_t) lrintf(value));
+        }
+    }
+
+    // Keep the last 'taps - 1' samples as history for the next block
+    for( int ch = 0; ch < _channels; ch++ ) {
+        memmove((void*) _windows[ch], (void*) &_windows[ch][newSamples], sizeof(float) * (_taps - 1));
+    }
+
+    return blocksize;
+}
@@ -0,0 +1,104 @@
+#include "boomaprofiler.h"
+
+thread_local BoomaStageTime* BoomaStageTime::_active = nullptr;
+
+BoomaStageTime::BoomaStageTime(std::string name):
+    _name(name),
+    _calls(0),
+    _total(0),
+    _max(0),
+    _parent(nullptr),
+    _nested(0) {}
+
+void BoomaStageTime::Begin() {
+    _parent = _active;
+    _active = this;
+    _nested = 0;
+    _start = std::chrono::steady_clock::now();
+}
+
+void BoomaStageTime::End() {
+    unsigned long long elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _start).count();
+
+    // Time spend in nested stages is accounted for by the nested stages
+    unsigned long long own = elapsed > _nested ? elapsed - _nested : 0;
+    _calls++;
+    _total += own;
+    if( own > _max ) {
+        _max = own;
+    }
+
+    // Let the calling stage know how much time we used
+    _active = _parent;
+    if( _parent != nullptr ) {
+        _parent->_nested += elapsed;
+    }
+}
+
+StageStatistics BoomaStageTime::GetStatistics() {
+    StageStatistics statistics;
+    statistics.Name = _name;
+    statistics.Calls = _calls;
+    statistics.Total = _total / 1000.0;
+    statistics.Max = _max / 1000.0;
+    return statistics;
+}
+
+BoomaStageWriterTimer::BoomaStageWriterTimer(std::string name, HWriterConsumer<int16_t>* consumer):
+    HWriter<int16_t>(name + "_timer"),
+    BoomaStageTime(name),
+    _writer(nullptr) {
+
+    consumer->SetWriter(this);
+}
+
+int BoomaStageWriterTimer::Write(int16_t* src, size_t blocksize) {
+    Begin();
+    int written = _writer->Write(src, blocksize);
+    End();
+    return written;
+}
+
+BoomaStageReaderTimer::BoomaStageReaderTimer(std::string name, HReader<int16_t>* reader):
+    HReader<int16_t>(name + "_timer"),
+    BoomaStageTime(name),
+    _reader(reader) {}
+
+int BoomaStageReaderTimer::Read(int16_t* dest, size_t blocksize) {
+    Begin();
+    int read = _reader->Read(dest, blocksize);
+    End();
+    return read;
+}
+
+BoomaProfiler::~BoomaProfiler() {
+    for( std::vector<BoomaStageTime*>::iterator it = _timers.begin(); it != _timers.end(); it++ ) {
+        delete (*it);
+    }
+}
+
+HWriterConsumer<int16_t>* BoomaProfiler::Wrap(std::string name, HWriterConsumer<int16_t>* consumer) {
+    if( !_enabled ) {
+        return consumer;
+    }
+    BoomaStageWriterTimer* timer = new BoomaStageWriterTimer(name, consumer);
+    _timers.push_back(timer);
+    return timer->Consumer();
+}
+
+HReader<int16_t>* BoomaProfiler::Wrap(std::string name, HReader<int16_t>* reader) {
+    if( !_enabled ) {
+        return reader;
+    }
+    BoomaStageReaderTimer* timer = new BoomaStageReaderTimer(name, reader);
+    _timers.push_back(timer);
+    return timer->Reader();
+}
+
+std::vector<StageStatistics> BoomaProfiler::GetStatistics() {
+    std::vector<StageStatistics> statistics;
+    for( std::vector<BoomaStageTime*>::iterator it = _timers.begin(); it != _timers.end(); it++ ) {
+        statistics.push_back((*it)->GetStatistics());
+    }
+    return statistics;
+}
@@ -0,0 +1,131 @@
+#include <cmath>
+
+#include "boomarationalresampler.h"
+#include "boomamemory.h"
+
+BoomaRationalResampler::BoomaRationalResampler(std::string id, HReader<int16_t>* reader, int interpolation, int decimation, float* coefficients, int taps, size_t blocksize, bool isIq):
+    HReader<int16_t>(id),
+    _reader(reader),
+    _interpolation(interpolation),
+    _decimation(decimation),
+    _blocksize(blocksize),
+    _channels(isIq ? 2 : 1),
+    _index(0),
+    _phase(0) {
+
+    _tapsPerPhase = (taps + _interpolation - 1) / _interpolation;
+    HLog("Creating rational resampler %d/%d with %d taps per phase for %s samples", _interpolation, _decimation, _tapsPerPhase, isIq ? "IQ" : "real");
+
+    // Split the prototype filter into phases. The filter runs at 'L' times the input
+    // rate with only every L'th input sample being non-zero, so the gain is scaled by L
+    _phases = new float*[_interpolation];
+    for( int p = 0; p < _interpolation; p++ ) {
+        _phases[p] = BoomaAllocate<float>(_tapsPerPhase);
+        for( int k = 0; k < _tapsPerPhase; k++ ) {
+            int tap = p + k * _interpolation;
+            _phases[p][_tapsPerPhase - 1 - k] = tap < taps ? coefficients[tap] * _interpolation : 0;
+        }
+    }
+
+    // Buffers must hold the history, the input for one output block and one extra upstream block
+    int samples = _blocksize / _channels;
+    int capacity = (_tapsPerPhase - 1) + (int) ceil((double) samples * _decimation / _interpolation) + 2 * samples;
+    _input = BoomaAllocate<int16_t>(_blocksize);
+    _buffers = new float*[_channels];
+    for( int ch = 0; ch < _channels; ch++ ) {
+        _buffers[ch] = BoomaAllocate<float>(capacity);
+        memset((void*) _buffers[ch], 0, sizeof(float) * capacity);
+    }
+    _length = _tapsPerPhase - 1;
+    _index = _tapsPerPhase - 1;
+}
+
+BoomaRationalResampler::~BoomaRationalResampler() {
+    for( int p = 0; p < _interpolation; p++ ) {
+        BoomaFree(_phases[p]);
+    }
+    delete[] _phases;
+    BoomaFree(_input);
+    for( int ch = 0; ch < _channels; ch++ ) {
+        BoomaFree(_buffers[ch]);
+    }
+    delete[] _buffers;
+}
+
+int BoomaRationalResampler::GetTaps(int interpolation, int inputRate, int outputRate, int cutoff, float attenuation) {
+
+    // Kaiser estimate with the transition band ending where the first alias
+    // would reach back into the passband
+    double rate = (double) inputRate * interpolation;
+    double transition = (double) (outputRate - 2 * cutoff) / rate;
+    int taps = (int) ceil((attenuation - 8) / (2.285 * 2 * M_PI * transition));
+
+    // Round up to a whole number of taps per phase, odd for a symmetric filter
+    taps = ((taps + interpolation - 1) / interpolation) * interpolation;
+    return taps % 2 == 0 ? taps + 1 : taps;
+}
+
+bool BoomaRationalResampler::Fill() {
+    int read = _reader->Read(_input, _blocksize);
+    if( read != (int) _blocksize ) {
+        HLog("Upstream reader returned %d, expected %d", read, _blocksize);
+        return false;
+    }
+
+    int samples = _blocksize / _channels;
+    for( int ch = 0; ch < _channels; ch++ ) {
+        float* buffer = &_buffers[ch][_length];
+        for( int i = 0; i < samples; i++ ) {
+            buffer[i] = _input[i * _channels + ch];
+        }
+    }
+    _length += samples;
+    return true;
+}
+
+int BoomaRationalResampler::Read(int16_t* dest, size_t blocksize) {
+
+    if( blocksize != _blocksize ) {
+        HError("Requested blocksize %d differs from the resampler blocksize %d", blocksize, _blocksize);
+        return 0;
+    }
+
+    int outputs = _blocksize / _channels;
+    for( int n = 0; n < outputs; n++ ) {
+
+        // Make sure the current input sample has been read
+        while( _index >= _length ) {
+            if( !Fill() ) {
+                return 0;
+            }
+        }
+
+        float* coefficients = _phases[_phase];
+        for( int ch = 0; ch < _channels; ch++ ) {
+            float* samples = &_buffers[ch][_index - _tapsPerPhase + 1];
+            float value = 0;
+            for( int k = 0; k < _tapsPerPhase; k++ ) {
+                value += coefficients[k] * samples[k];
+            }
+            dest[n * _channels + ch] = value > 32767 ? 32767 : (value < -32768 ? -32768 : (int16_t) lrintf(value));
+        }
+
+        // Advance M steps at the interpolated rate
+        _phase += _decimation;
+        _index += _phase / _interpolation;
+        _phase %= _interpolation;
+    }
+
+    // Drop samples that are no longer needed as history. The index may point
+    // beyond the samples read so far, these will be skipped on the next read
+    int drop = (_index < _length ? _index : _length) - (_tapsPerPhase - 1);
+    if( drop > 0 ) {
+        for( int ch = 0; ch < _channels; ch++ ) {
+            memmove((void*) _buffers[ch], (void*) &_buffers[ch][drop], sizeof(float) * (_length - drop));
+        }
+        _length -= drop;
+        _index -= drop;
+    }
+
+    return blocksize;
+}
@@ -98,6 +98,10 @@ int BoomaReceiver::SetRfGain(int gain) {
 }
 
 void BoomaReceiver::Build(ConfigOptions* opts, BoomaInput* input, BoomaDecoder* decoder) {
+    Build(opts, input->GetLastWriterConsumer(), decoder);
+}
+
+void BoomaReceiver::Build(ConfigOptions* opts, HWriterConsumer<int16_t>* source, BoomaDecoder* decoder) {
 
     // Can we build a receiver for the given input data type ?
     if( !IsDataTypeSupported(opts->GetInputSourceDataType()) ) {
@@ -123,9 +127,12 @@ void BoomaReceiver::Build(ConfigOptions* opts, BoomaInput* input, BoomaDecoder*
         opts->SetFrequency(GetDefaultFrequency(opts));
     }
 
+    // Stage profiling (does nothing unless enabled)
+    _profiler = new BoomaProfiler(opts->GetEnableProfiling());
+
     // Add receiver gain/agc
     _gainValue = opts->GetRfGain();
-    _rfAgc = new HAgc<int16_t>("receiver_agc", input->GetLastWriterConsumer(), GetRfAgcLevel(opts), 10, BLOCKSIZE, 6, false);
+    _rfAgc = new HAgc<int16_t>("receiver_agc", Profile("receiver_agc", source), GetRfAgcLevel(opts), 10, opts->GetBlocksize(), 6, false);
     if( opts->GetRfGain() != 0 ) {
         if( opts->GetRfGainEnabled() ) {
             float g =
@@ -146,7 +153,7 @@ void BoomaReceiver::Build(ConfigOptions* opts, BoomaInput* input, BoomaDecoder*
     _postProcess = PostProcess(opts, _receive);
 
     // Add a splitter so that we can push fully processed samples through an optional decoder
-    _decoder = new HSplitter<int16_t>("receiver_decoder_splitter", _postProcess->Consumer());
+    _decoder = new BoomaSplitter("receiver_decoder_splitter", Profile("receiver_decoder_splitter", _postProcess->Consumer()), opts->GetBlocksize());
     if( decoder != NULL ) {
         _decoder->SetWriter(decoder->Writer());
     }
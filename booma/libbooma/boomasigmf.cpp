@@ -0,0 +1,200 @@
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <sstream>
+
+#include "boomasigmf.h"
+
+BoomaSigMFWriter::BoomaSigMFWriter(std::string id, std::string filename, HWriterConsumer<int16_t>* consumer, int rate, bool isIq, InputSourceType source, long frequency, long tuned, int gain, unsigned long delay, size_t blocksize, int blocks):
+    HWriter<int16_t>(id),
+    _filename(filename),
+    _dump(nullptr),
+    _recording(false),
+    _rate(rate),
+    _channels(isIq ? 2 : 1),
+    _source(source),
+    _delay(delay),
+    _written(0),
+    _frequency(frequency),
+    _tuned(tuned),
+    _gain(gain) {
+
+    if( blocks > 0 ) {
+        _dump = new BoomaDumpWriter(id + "_dump", filename, ".sigmf-data", rate, _channels, blocksize, blocks);
+    }
+    consumer->SetWriter(this);
+}
+
+BoomaSigMFWriter::~BoomaSigMFWriter() {
+    Stop();
+    SAFE_DELETE(_dump);
+}
+
+std::string BoomaSigMFWriter::Now(double offset) {
+    std::chrono::system_clock::time_point now = std::chrono::system_clock::now() + std::chrono::milliseconds((long long) (offset * 1000));
+    std::time_t seconds = std::chrono::system_clock::to_time_t(now);
+    int millis = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count() % 1000;
+
+    struct tm utc;
+    gmtime_r(&seconds, &utc);
+    char datetime[32];
+    strftime(datetime, sizeof(datetime), "%Y-%m-%dT%H:%M:%S", &utc);
+    snprintf(datetime + strlen(datetime), sizeof(datetime) - strlen(datetime), ".%03dZ", millis);
+    return datetime;
+}
+
+int BoomaSigMFWriter::Write(int16_t* src, size_t blocksize) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    // Open the recording when the first samples arrive, the dump writer opens its own file
+    if( !_recording ) {
+        HLog("Recording rf input to %s.sigmf-data", _filename.c_str());
+        if( _dump == nullptr ) {
+            _data.open((_filename + ".sigmf-data").c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+            if( !_data.is_open() ) {
+                HError("Unable to open %s.sigmf-data", _filename.c_str());
+                return 0;
+            }
+        }
+        _recording = true;
+        Event capture = {0, Now(-(double) _delay / _rate), _frequency, _tuned, _gain};
+        _captures.push_back(capture);
+    }
+
+    // Index every second of samples, the samples being written are 'delay' frames old
+    if( _written / _rate >= _index.size() ) {
+        Event entry = {_written, Now(-(double) _delay / _rate), 0, 0, 0};
+        _index.push_back(entry);
+    }
+
+    if( _dump != nullptr ) {
+        if( !_dump->Queue(src, blocksize) ) {
+            return blocksize;
+        }
+    } else {
+        _data.write((char*) src, blocksize * sizeof(int16_t));
+    }
+    _written += blocksize / _channels;
+    return blocksize;
+}
+
+bool BoomaSigMFWriter::Stop() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if( _recording ) {
+        if( _dump != nullptr ) {
+            _dump->Stop();
+        } else {
+            _data.close();
+        }
+        _recording = false;
+        WriteMetadata();
+    }
+    return true;
+}
+
+void BoomaSigMFWriter::Retune(long frequency, long tuned) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if( frequency == _frequency && tuned == _tuned ) {
+        return;
+    }
+    _frequency = frequency;
+    _tuned = tuned;
+
+    // Before the recording starts, the frequency goes into the first capture
+    if( _recording ) {
+        Event capture = {_written + _delay, Now(), frequency, tuned, _gain};
+        _captures.push_back(capture);
+    }
+}
+
+void BoomaSigMFWriter::SetGain(int gain) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if( gain == _gain ) {
+        return;
+    }
+    _gain = gain;
+    if( _recording ) {
+        Event annotation = {_written + _delay, Now(), _frequency, _tuned, gain};
+        _annotations.push_back(annotation);
+    }
+}
+
+void BoomaSigMFWriter::WriteMetadata() {
+    HLog("Writing rf recording metadata to %s.sigmf-meta", _filename.c_str());
+    std::ofstream meta((_filename + ".sigmf-meta").c_str(), std::ios::out | std::ios::trunc);
+    if( !meta.is_open() ) {
+        HError("Unable to open %s.sigmf-meta", _filename.c_str());
+        return;
+    }
+
+    meta << "{" << std::endl;
+    meta << "    \"global\": {" << std::endl;
+    meta << "        \"core:datatype\": \"" << (_channels == 2 ? "ci16_le" : "ri16_le") << "\"," << std::endl;
+    meta << "        \"core:sample_rate\": " << _rate << "," << std::endl;
+    meta << "        \"core:version\": \"1.0.0\"," << std::endl;
+    meta << "        \"core:recorder\": \"Booma\"," << std::endl;
+    meta << "        \"booma:source\": " << _source << "," << std::endl;
+    meta << "        \"booma:index\": [";
+    for( std::vector<Event>::iterator it = _index.begin(); it != _index.end(); it++ ) {
+        meta << (it == _index.begin() ? "" : ",") << std::endl;
+        meta << "            {\"core:sample_start\": " << it->Sample << ", \"booma:offset\": " << it->Sample * _channels * sizeof(int16_t) << ", \"core:datetime\": \"" << it->Datetime << "\"}";
+    }
+    meta << std::endl << "        ]" << std::endl;
+    meta << "    }," << std::endl;
+
+    meta << "    \"captures\": [";
+    for( std::vector<Event>::iterator it = _captures.begin(); it != _captures.end(); it++ ) {
+        meta << (it == _captures.begin() ? "" : ",") << std::endl;
+        meta << "        {\"core:sample_start\": " << it->Sample << ", \"core:frequency\": " << it->Frequency << ", \"core:datetime\": \"" << it->Datetime << "\", \"booma:frequency\": " << it->Tuned << ", \"booma:gain\": " << it->Gain << "}";
+    }
+    meta << std::endl << "    ]," << std::endl;
+
+    meta << "    \"annotations\": [";
+    for( std::vector<Event>::iterator it = _annotations.begin(); it != _annotations.end(); it++ ) {
+        meta << (it == _annotations.begin() ? "" : ",") << std::endl;
+        meta << "        {\"core:sample_start\": " << it->Sample << ", \"core:label\": \"gain\", \"core:comment\": \"" << it->Datetime << "\", \"booma:gain\": " << it->Gain << "}";
+    }
+    meta << std::endl << "    ]" << std::endl;
+    meta << "}" << std::endl;
+}
+
+// Value following '"key":' as a string, the sidecar is written by BoomaSigMFWriter so no full json parser is needed
+static std::string FindValue(std::string json, std::string key) {
+    size_t at = json.find("\"" + key + "\"");
+    if( at == std::string::npos ) {
+        return "";
+    }
+    at = json.find(':', at + key.length() + 2);
+    size_t start = json.find_first_not_of(" \t\r\n\"", at + 1);
+    size_t end = json.find_first_of(",}\"\r\n", start);
+    return start == std::string::npos ? "" : json.substr(start, end - start);
+}
+
+bool BoomaSigMFMetadata::Read(std::string filename) {
+    std::string base = filename.substr(0, filename.rfind(".sigmf-"));
+    std::ifstream meta((base + ".sigmf-meta").c_str());
+    if( !meta.is_open() ) {
+        return false;
+    }
+    std::stringstream json;
+    json << meta.rdbuf();
+
+    std::string datatype = FindValue(json.str(), "core:datatype");
+    std::string rate = FindValue(json.str(), "core:sample_rate");
+    if( (datatype != "ci16_le" && datatype != "ri16_le") || rate.empty() ) {
+        HError("Unsupported or incomplete SigMF metadata in %s.sigmf-meta", base.c_str());
+        return false;
+    }
+    SampleRate = atoi(rate.c_str());
+    IsIq = datatype == "ci16_le";
+    Source = (InputSourceType) atoi(FindValue(json.str(), "booma:source").c_str());
+
+    // The frequency of the first capture is where the recording started
+    size_t captures = json.str().find("\"captures\"");
+    if( captures != std::string::npos ) {
+        std::string tuned = FindValue(json.str().substr(captures), "booma:frequency");
+        Frequency = atol((tuned.empty() ? FindValue(json.str().substr(captures), "core:frequency") : tuned).c_str());
+    }
+    DataFile = base + ".sigmf-data";
+    return true;
+}
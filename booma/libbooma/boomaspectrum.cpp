@@ -0,0 +1,217 @@
+#include <cmath>
+
+#include "boomaspectrum.h"
+#include "boomamemory.h"
+#include "boomaconfigurationexception.h"
+#include "boomakaiserbesseldesigner.h"
+
+BoomaSpectrum::BoomaSpectrum(std::string id, HWriterConsumer<int16_t>* consumer, int rate, bool isIq, BoomaSpectrumWindow window, int zoom, int size, int overlap, int averaging):
+    HWriter<int16_t>(id),
+    _isIq(isIq),
+    _windowType(window),
+    _zoom(isIq ? 1 : zoom),
+    _fft(nullptr),
+    _window(nullptr),
+    _re(nullptr),
+    _im(nullptr),
+    _sum(nullptr),
+    _samples(nullptr),
+    _zoomCoefficients(nullptr),
+    _zoomTaps(0),
+    _zoomHistory(nullptr),
+    _zoomPhase(0),
+    _pending(false) {
+
+    HLog("Creating spectrum with fft size %d, overlap %d%%, averaging %d and zoom %d", size, overlap, averaging, _zoom);
+    if( !IsValid(size, overlap, averaging) ) {
+        throw new BoomaConfigurationException("Invalid spectrum fft size, overlap or averaging");
+    }
+
+    // Lowpass filter for zooming in on the lower part of the spectrum
+    if( _zoom > 1 ) {
+        _zoomTaps = 16 * _zoom + 1;
+        _zoomCoefficients = BoomaAllocate<float>(_zoomTaps);
+        memcpy((void*) _zoomCoefficients, (void*) BoomaKaiserBesselDesigner::Lowpass(0.9 * rate / (2 * _zoom), rate, _zoomTaps, 50).data(), sizeof(float) * _zoomTaps);
+        _zoomHistory = BoomaAllocate<float>(2 * _zoomTaps);
+        memset((void*) _zoomHistory, 0, sizeof(float) * 2 * _zoomTaps);
+    }
+
+    _buffer = new BoomaSpectrumBuffer(MAX_SPECTRUM_FFT_SIZE / 2, size / 2);
+
+    _requestedSize = size;
+    _requestedOverlap = overlap;
+    _requestedAveraging = averaging;
+    Apply();
+
+    consumer->SetWriter(this);
+}
+
+BoomaSpectrum::~BoomaSpectrum() {
+    Release();
+    delete _buffer;
+    if( _zoomHistory != nullptr ) {
+        BoomaFree(_zoomHistory);
+    }
+    if( _zoomCoefficients != nullptr ) {
+        BoomaFree(_zoomCoefficients);
+    }
+}
+
+bool BoomaSpectrum::IsValid(int size, int overlap, int averaging) {
+    if( size < 64 || size > MAX_SPECTRUM_FFT_SIZE || (size & (size - 1)) != 0 ) {
+        HError("Spectrum fft size %d must be a power of 2 from 64 to %d", size, MAX_SPECTRUM_FFT_SIZE);
+        return false;
+    }
+    if( overlap < 0 || overlap > 90 ) {
+        HError("Spectrum overlap %d must be from 0 to 90 percent", overlap);
+        return false;
+    }
+    if( averaging < 1 || averaging > 100 ) {
+        HError("Spectrum averaging %d must be from 1 to 100", averaging);
+        return false;
+    }
+    return true;
+}
+
+bool BoomaSpectrum::Configure(int size, int overlap, int averaging) {
+    if( !IsValid(size, overlap, averaging) ) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    _requestedSize = size;
+    _requestedOverlap = overlap;
+    _requestedAveraging = averaging;
+    _pending = true;
+    return true;
+}
+
+int BoomaSpectrum::GetSize() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _requestedSize;
+}
+
+int BoomaSpectrum::GetOverlap() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _requestedOverlap;
+}
+
+int BoomaSpectrum::GetAveraging() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _requestedAveraging;
+}
+
+void BoomaSpectrum::Release() {
+    SAFE_DELETE(_fft);
+    if( _window != nullptr ) {
+        BoomaFree(_window);
+        BoomaFree(_re);
+        BoomaFree(_im);
+        BoomaFree(_sum);
+        BoomaFree(_samples);
+    }
+}
+
+void BoomaSpectrum::Apply() {
+    HLog("Setting spectrum fft size %d, overlap %d%% and averaging %d", _requestedSize, _requestedOverlap, _requestedAveraging);
+    Release();
+
+    _size = _requestedSize;
+    _points = _isIq ? _size / 2 : _size;
+    _hop = (_points * (100 - _requestedOverlap)) / 100;
+    _averaging = _requestedAveraging;
+    _pending = false;
+
+    _fft = new BoomaFft(_points);
+    _window = BoomaAllocate<float>(_points);
+    for( int i = 0; i < _points; i++ ) {
+        _window[i] = _windowType == HAMMING_WINDOW
+            ? 0.54 - 0.46 * cos(2 * M_PI * i / (_points - 1))
+            : 1;
+    }
+    _re = BoomaAllocate<float>(_points);
+    _im = BoomaAllocate<float>(_points);
+    _sum = BoomaAllocate<double>(_size / 2);
+    memset((void*) _sum, 0, sizeof(double) * (_size / 2));
+    _averaged = 0;
+
+    _samples = BoomaAllocate<float>(_points * (_isIq ? 2 : 1));
+    _count = 0;
+}
+
+int BoomaSpectrum::Write(int16_t* src, size_t blocksize) {
+
+    // Pick up new settings
+    if( _pending ) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        Apply();
+    }
+
+    if( _zoom == 1 ) {
+        for( size_t i = 0; i < blocksize; i++ ) {
+            _samples[_count++] = src[i];
+            if( _count == _points * (_isIq ? 2 : 1) ) {
+                Calculate();
+            }
+        }
+        return blocksize;
+    }
+
+    // Lowpass filter and keep every 'zoom' sample. The history is stored twice
+    // so that the last 'taps' samples are always available as one array
+    for( size_t i = 0; i < blocksize; i++ ) {
+        _zoomHistory[_zoomPhase % _zoomTaps] = src[i];
+        _zoomHistory[(_zoomPhase % _zoomTaps) + _zoomTaps] = src[i];
+        _zoomPhase++;
+        if( _zoomPhase % _zoom == 0 ) {
+            float* window = &_zoomHistory[_zoomPhase % _zoomTaps];
+            float value = 0;
+            for( int j = 0; j < _zoomTaps; j++ ) {
+                value += _zoomCoefficients[j] * window[j];
+            }
+            _samples[_count++] = value;
+            if( _count == _points ) {
+                Calculate();
+            }
+        }
+        if( _zoomPhase == _zoomTaps * _zoom ) {
+            _zoomPhase = 0;
+        }
+    }
+    return blocksize;
+}
+
+void BoomaSpectrum::Calculate() {
+
+    if( _isIq ) {
+        for( int i = 0; i < _points; i++ ) {
+            _re[i] = _samples[2 * i] * _window[i];
+            _im[i] = _samples[2 * i + 1] * _window[i];
+        }
+    } else {
+        for( int i = 0; i < _points; i++ ) {
+            _re[i] = _samples[i] * _window[i];
+            _im[i] = 0;
+        }
+    }
+    _fft->Forward(_re, _im);
+
+    int bins = _size / 2;
+    for( int i = 0; i < bins; i++ ) {
+        _sum[i] += sqrt(_re[i] * _re[i] + _im[i] * _im[i]);
+    }
+    if( ++_averaged == _averaging ) {
+        for( int i = 0; i < bins; i++ ) {
+            _sum[i] /= _averaging;
+        }
+        _buffer->Publish(_sum, bins);
+        memset((void*) _sum, 0, sizeof(double) * bins);
+        _averaged = 0;
+    }
+
+    // Keep the overlapping samples for the next fft
+    int channels = _isIq ? 2 : 1;
+    int keep = (_points - _hop) * channels;
+    memmove((void*) _samples, (void*) &_samples[_hop * channels], sizeof(float) * keep);
+    _count = keep;
+}
@@ -0,0 +1,79 @@
+#include <cstring>
+
+#include "boomaspectrumbuffer.h"
+#include "boomamemory.h"
+
+BoomaSpectrumBuffer::BoomaSpectrumBuffer(int capacity, int size):
+    _capacity(capacity),
+    _sequence(0),
+    _size(size) {
+
+    for( int i = 0; i < 3; i++ ) {
+        _slots[i].Version.store(0);
+        _slots[i].Sequence = 0;
+        _slots[i].Size = size;
+        _slots[i].Timestamp = std::chrono::steady_clock::now();
+        _slots[i].Spectrum = BoomaAllocate<double>(_capacity);
+        memset((void*) _slots[i].Spectrum, 0, sizeof(double) * _capacity);
+    }
+}
+
+BoomaSpectrumBuffer::~BoomaSpectrumBuffer() {
+    for( int i = 0; i < 3; i++ ) {
+        BoomaFree(_slots[i].Spectrum);
+    }
+}
+
+void BoomaSpectrumBuffer::Publish(double* spectrum, int size) {
+    unsigned long sequence = _sequence.load(std::memory_order_relaxed) + 1;
+    Slot* slot = &_slots[sequence % 3];
+
+    // Mark the slot as being written
+    unsigned long version = slot->Version.load(std::memory_order_relaxed);
+    slot->Version.store(version + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot->Size = size < _capacity ? size : _capacity;
+    memcpy((void*) slot->Spectrum, (void*) spectrum, sizeof(double) * slot->Size);
+    slot->Sequence = sequence;
+    slot->Timestamp = std::chrono::steady_clock::now();
+
+    // Done, then make it the newest frame
+    slot->Version.store(version + 2, std::memory_order_release);
+    _size.store(slot->Size, std::memory_order_release);
+    _sequence.store(sequence, std::memory_order_release);
+}
+
+int BoomaSpectrumBuffer::Read(double* spectrum, int size, unsigned long* sequence, std::chrono::steady_clock::time_point* timestamp) {
+    while( true ) {
+        unsigned long newest = _sequence.load(std::memory_order_acquire);
+        if( sequence != nullptr && newest == *sequence ) {
+            return 0;
+        }
+
+        Slot* slot = &_slots[newest % 3];
+        unsigned long version = slot->Version.load(std::memory_order_acquire);
+        if( (version & 1) != 0 ) {
+            continue;
+        }
+
+        int length = slot->Size < size ? slot->Size : size;
+        memcpy((void*) spectrum, (void*) slot->Spectrum, sizeof(double) * length);
+        unsigned long copied = slot->Sequence;
+        std::chrono::steady_clock::time_point published = slot->Timestamp;
+
+        // If the writer got to the slot while we were copying, then try again
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if( slot->Version.load(std::memory_order_relaxed) != version ) {
+            continue;
+        }
+
+        if( sequence != nullptr ) {
+            *sequence = copied;
+        }
+        if( timestamp != nullptr ) {
+            *timestamp = published;
+        }
+        return length;
+    }
+}
@@ -0,0 +1,81 @@
+#include "boomasplitter.h"
+
+BoomaSplitter::BoomaSplitter(std::string id, HWriterConsumer<int16_t>* consumer, size_t blocksize):
+    HWriter<int16_t>(id),
+    _pool(BoomaBlockPool<int16_t>::Get(blocksize)) {
+
+    consumer->SetWriter(this);
+}
+
+void BoomaSplitter::SetWriter(HWriter<int16_t>* writer, bool inPlace) {
+    Branch branch = { inPlace ? IN_PLACE : SHARED, writer, nullptr };
+    _branches.push_back(branch);
+}
+
+void BoomaSplitter::SetBlockWriter(BoomaBlockWriter* writer) {
+
+    // Block writers that are also writers are started, stopped and commanded as any other branch
+    Branch branch = { BLOCK, dynamic_cast<HWriter<int16_t>*>(writer), writer };
+    _branches.push_back(branch);
+}
+
+int BoomaSplitter::Write(int16_t* src, size_t blocksize) {
+
+    // Pooled copy shared by all block writers, taken when first needed
+    BoomaBlock<int16_t>* shared = nullptr;
+
+    for( std::vector<Branch>::iterator it = _branches.begin(); it != _branches.end(); it++ ) {
+        switch( (*it).Type ) {
+            case SHARED:
+                (*it).Writer->Write(src, blocksize);
+                break;
+            case IN_PLACE: {
+                BoomaBlock<int16_t>* copy = _pool->Copy(src, blocksize);
+                (*it).Writer->Write(copy->GetData(), blocksize);
+                copy->Release();
+                break;
+            }
+            case BLOCK:
+                if( shared == nullptr ) {
+                    shared = _pool->Copy(src, blocksize);
+                }
+                (*it).BlockWriter->WriteBlock(shared);
+                break;
+        }
+    }
+
+    if( shared != nullptr ) {
+        shared->Release();
+    }
+    return blocksize;
+}
+
+bool BoomaSplitter::Start() {
+    bool result = true;
+    for( std::vector<Branch>::iterator it = _branches.begin(); it != _branches.end(); it++ ) {
+        if( (*it).Writer != nullptr ) {
+            result &= (*it).Writer->Start();
+        }
+    }
+    return result;
+}
+
+bool BoomaSplitter::Stop() {
+    bool result = true;
+    for( std::vector<Branch>::iterator it = _branches.begin(); it != _branches.end(); it++ ) {
+        if( (*it).Writer != nullptr ) {
+            result &= (*it).Writer->Stop();
+        }
+    }
+    return result;
+}
+
+bool BoomaSplitter::Command(HCommand* command) {
+    bool result = true;
+    for( std::vector<Branch>::iterator it = _branches.begin(); it != _branches.end(); it++ ) {
+        if( (*it).Writer != nullptr ) {
+            result &= (*it).Writer->Command(command);
+        }
+    }
+    return result;
+}
@@ -1,4 +1,5 @@
 #include "boomassbreceiver.h"
+#include "boomakaiserbesseldesigner.h"
 
 BoomaSsbReceiver::BoomaSsbReceiver(ConfigOptions* opts, int initialFrequency):
         BoomaReceiver(opts, initialFrequency),
@@ -29,20 +30,20 @@ BoomaSsbReceiver::BoomaSsbReceiver(ConfigOptions* opts, int initialFrequency):
 HWriterConsumer<int16_t>* BoomaSsbReceiver::PreProcess(ConfigOptions* opts, HWriterConsumer<int16_t>* previous) {
     HLog("Creating SSB receiver preprocessing chain");
 
-    _inputFirFilter = new HIqFirFilter<int16_t>("ssb_receiver_pre_process_input_fir", previous, HLowpassKaiserBessel<int16_t>(2000, opts->GetOutputSampleRate(), 15, 50).Calculate(), 15, BLOCKSIZE);
+    _inputFirFilter = new HIqFirFilter<int16_t>("ssb_receiver_pre_process_input_fir", Profile("ssb_receiver_pre_process_input_fir", previous), BoomaKaiserBesselDesigner::Lowpass(2000, opts->GetOutputSampleRate(), 15, 50).data(), 15, opts->GetBlocksize());
 
     // Move the center frequency up to 3000 (place the carrier at 3KHz)
-    _iqMultiplier = new HIqMultiplier<int16_t>("ssb_receiver_pre_process_iq_multiplier", _inputFirFilter->Consumer(), opts->GetOutputSampleRate(), 3000, 10, BLOCKSIZE);
+    _iqMultiplier = new BoomaIqMixer("ssb_receiver_pre_process_iq_multiplier", Profile("ssb_receiver_pre_process_iq_multiplier", _inputFirFilter->Consumer()), opts->GetOutputSampleRate(), 3000, opts->GetBlocksize());
 
     // Remove (formerly) negative frequencies by passband filtering
     if( GetOption("Mode") > 0) {
-        _iqFirFilter = new HIqFirFilter<int16_t>("ssb_receiver_pre_process_passband_fir", _iqMultiplier->Consumer(), HBandpassKaiserBessel<int16_t>(3000, 6000, opts->GetOutputSampleRate(), 15, 50).Calculate(), 15, BLOCKSIZE);
+        _iqFirFilter = new HIqFirFilter<int16_t>("ssb_receiver_pre_process_passband_fir", Profile("ssb_receiver_pre_process_passband_fir", _iqMultiplier->Consumer()), BoomaKaiserBesselDesigner::Bandpass(3000, 6000, opts->GetOutputSampleRate(), 15, 50).data(), 15, opts->GetBlocksize());
     } else {
-        _iqFirFilter = new HIqFirFilter<int16_t>("ssb_receiver_pre_process_passband_fir", _iqMultiplier->Consumer(), HLowpassKaiserBessel<int16_t>(3000, opts->GetOutputSampleRate(), 15, 50).Calculate(), 15, BLOCKSIZE);
+        _iqFirFilter = new HIqFirFilter<int16_t>("ssb_receiver_pre_process_passband_fir", Profile("ssb_receiver_pre_process_passband_fir", _iqMultiplier->Consumer()), BoomaKaiserBesselDesigner::Lowpass(3000, opts->GetOutputSampleRate(), 15, 50).data(), 15, opts->GetBlocksize());
     }
 
     // Move the carrier back down to zero
-    _basebandMultiplier = new HIqMultiplier<int16_t>("ssb_receiver_pre_process_iq_baseband_multiplier", _iqFirFilter->Consumer(), opts->GetOutputSampleRate(), -3000, 10, BLOCKSIZE);
+    _basebandMultiplier = new BoomaIqMixer("ssb_receiver_pre_process_iq_baseband_multiplier", Profile("ssb_receiver_pre_process_iq_baseband_multiplier", _iqFirFilter->Consumer()), opts->GetOutputSampleRate(), -3000, opts->GetBlocksize());
     return _basebandMultiplier->Consumer();
 }
 
@@ -50,11 +51,11 @@ HWriterConsumer<int16_t>* BoomaSsbReceiver::Receive(ConfigOptions* opts, HWriter
     HLog("Creating SSB receiving chain");
 
     // Demodulate usb or lsb by use of the Weaver or "3rd." method.
-    _iqAdder = new HIqAddOrSubtractConverter<int16_t>("ssb_receiver_receive_demodulator", previous, false, BLOCKSIZE);
+    _iqAdder = new HIqAddOrSubtractConverter<int16_t>("ssb_receiver_receive_demodulator", Profile("ssb_receiver_receive_demodulator", previous), false, opts->GetBlocksize());
 
-    // The iq-adder returns half the amount of incomming samples which equals BLOCKSIZE/2
-    // Get back to the global BLOCKSIZE by collecting two blocks before writing further downstream
-    _collector = new HCollector<int16_t>("ssb_receiver_receive_collector", _iqAdder->Consumer(), BLOCKSIZE / 2, BLOCKSIZE);
+    // The iq-adder returns half the amount of incomming samples which equals blocksize/2
+    // Get back to the global blocksize by collecting two blocks before writing further downstream
+    _collector = new HCollector<int16_t>("ssb_receiver_receive_collector", Profile("ssb_receiver_receive_collector", _iqAdder->Consumer()), opts->GetBlocksize() / 2, opts->GetBlocksize());
 
     return _collector->Consumer();
 }
@@ -63,7 +64,7 @@ HWriterConsumer<int16_t>* BoomaSsbReceiver::PostProcess(ConfigOptions* opts, HWr
     HLog("Creating SSB receiver postprocessing chain");
 
     // And finally, filter out the high copy of the spectrum that is created by the translation
-    _lowpassFilter = new HBiQuadFilter<HLowpassBiQuad<int16_t>, int16_t>("ssb_receiver_post_process_lowpass", previous, 3000, opts->GetOutputSampleRate(), 0.707, 1, BLOCKSIZE);
+    _lowpassFilter = new HBiQuadFilter<HLowpassBiQuad<int16_t>, int16_t>("ssb_receiver_post_process_lowpass", Profile("ssb_receiver_post_process_lowpass", previous), 3000, opts->GetOutputSampleRate(), 0.707, 1, opts->GetBlocksize());
 
     // Return final signal
     return _lowpassFilter->Consumer();
@@ -94,9 +95,9 @@ void BoomaSsbReceiver::OptionChanged(ConfigOptions* opts, std::string name, int
     HLog("Option %s has changed to value %d", name.c_str(), value);
 
     if( value > 0 ) {
-        _iqFirFilter->SetCoefficients(HBandpassKaiserBessel<int16_t>(3000, 6000, opts->GetOutputSampleRate(), 15, 50).Calculate(), 15);
+        _iqFirFilter->SetCoefficients(BoomaKaiserBesselDesigner::Bandpass(3000, 6000, opts->GetOutputSampleRate(), 15, 50).data(), 15);
     } else {
-        _iqFirFilter->SetCoefficients(HLowpassKaiserBessel<int16_t>(3000, opts->GetOutputSampleRate(), 15, 50).Calculate(), 15);
+        _iqFirFilter->SetCoefficients(BoomaKaiserBesselDesigner::Lowpass(3000, opts->GetOutputSampleRate(), 15, 50).data(), 15);
     }
 
     // Settings applied
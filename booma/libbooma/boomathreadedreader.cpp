@@ -0,0 +1,129 @@
+#include "boomathreadedreader.h"
+#include "boomamemory.h"
+
+BoomaThreadedReader::BoomaThreadedReader(std::string id, HReader<int16_t>* reader, size_t blocksize, int blocks, bool live):
+    HReader<int16_t>(id),
+    _reader(reader),
+    _live(live),
+    _thread(nullptr),
+    _running(false),
+    _finished(false),
+    _dropped(0) {
+
+    HLog("Creating threaded reader with %d blocks of %d samples for %s input", blocks, blocksize, live ? "live" : "non-live");
+    _ring = new BoomaBlockRing<int16_t>(blocks, blocksize);
+    _overflow = BoomaAllocate<int16_t>(blocksize);
+}
+
+BoomaThreadedReader::~BoomaThreadedReader() {
+    Stop();
+    delete _ring;
+    BoomaFree(_overflow);
+}
+
+bool BoomaThreadedReader::Start() {
+    if( _thread != nullptr ) {
+        return true;
+    }
+    if( !_reader->Start() ) {
+        HError("Upstream reader failed to start");
+        return false;
+    }
+
+    _running = true;
+    _finished = false;
+    _thread = new std::thread( [this]() { Produce(); } );
+    return true;
+}
+
+bool BoomaThreadedReader::Stop() {
+    if( _thread == nullptr ) {
+        return true;
+    }
+
+    // Stop the upstream reader first, the producer may be blocked in its Read()
+    _running = false;
+    Notify();
+    bool stopped = _reader->Stop();
+    _thread->join();
+    delete _thread;
+    _thread = nullptr;
+
+    if( _dropped > 0 ) {
+        HError("Threaded reader dropped %lu blocks since the chain could not keep up", (unsigned long) _dropped);
+    }
+    return stopped;
+}
+
+void BoomaThreadedReader::Notify() {
+
+    // Taking the lock makes sure a waiter is either before its check or already waiting
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+    }
+    _changed.notify_all();
+}
+
+void BoomaThreadedReader::Produce() {
+    HLog("Threaded reader is running");
+    while( _running ) {
+
+        // Input that is not live (files, generators) waits for room in the ring
+        int16_t* block = _ring->WriteBlock();
+        if( block == nullptr && !_live ) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _changed.wait(lock, [this]() { return !_running || _ring->WriteBlock() != nullptr; });
+            continue;
+        }
+
+        // Read into the ring if there is room, otherwise read and discard the block
+        int read = _reader->Read(block != nullptr ? block : _overflow, _ring->GetBlocksize());
+        if( read <= 0 ) {
+            HLog("Upstream reader returned %d, ending threaded reader", read);
+            break;
+        }
+        if( block != nullptr ) {
+            _ring->Commit(read);
+            Notify();
+        } else {
+            _dropped++;
+        }
+    }
+    _finished = true;
+    Notify();
+    HLog("Threaded reader has stopped");
+}
+
+int BoomaThreadedReader::Read(int16_t* dest, size_t blocksize) {
+
+    // Make sure we are running, the processor may not have called Start()
+    if( _thread == nullptr && !Start() ) {
+        return 0;
+    }
+
+    if( blocksize != _ring->GetBlocksize() ) {
+        HError("Requested blocksize %d differs from the ring blocksize %d", blocksize, _ring->GetBlocksize());
+        return 0;
+    }
+
+    // Wait for the next block. Blocks are committed before the producer
+    // finishes, so an empty ring after it has finished means we are drained
+    int length;
+    int16_t* block = nullptr;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _changed.wait(lock, [&]() { return (block = _ring->ReadBlock(&length)) != nullptr || _finished; });
+    }
+    if( block == nullptr ) {
+        return 0;
+    }
+
+    memcpy((void*) dest, (void*) block, length * sizeof(int16_t));
+    _ring->Release();
+
+    // A producer reading from a file may be waiting for room
+    if( !_live ) {
+        Notify();
+    }
+    return length;
+}
@@ -0,0 +1,228 @@
+#include <cmath>
+#include <cstring>
+
+#include "boomatimeshift.h"
+#include "boomamemory.h"
+
+// Blocks next to the capture thread's write position that the chain never reads
+#define TIMESHIFT_GUARD_BLOCKS 2
+
+BoomaTimeShift::BoomaTimeShift(std::string id, HReader<int16_t>* reader, size_t blocksize, int rate, int channels, int seconds, float speed, bool live, BoomaLatency* latency):
+    HReader<int16_t>(id),
+    _reader(reader),
+    _blocksize(blocksize),
+    _rate(rate),
+    _channels(channels),
+    _speed(speed),
+    _live(live),
+    _latency(latency),
+    _head(0),
+    _position(0),
+    _isShifted(false),
+    _last((unsigned long) -1),
+    _thread(nullptr),
+    _running(false),
+    _finished(false),
+    _rewoundPosition(0),
+    _catchUpSpeed(0) {
+
+    _blocks = (size_t) ceil((double) rate * channels * seconds / blocksize) + TIMESHIFT_GUARD_BLOCKS;
+    _buffer = BoomaAllocate<int16_t>(_blocks * _blocksize);
+    _lengths = BoomaAllocate<int>(_blocks);
+    memset((void*) _buffer, 0, sizeof(int16_t) * _blocks * _blocksize);
+    HLog("Creating time shift buffer of %d seconds, %.1f MB per minute, %.1f MB in total", seconds,
+         GetMemoryPerMinute() / (1024 * 1024), (double) _blocks * _blocksize * sizeof(int16_t) / (1024 * 1024));
+}
+
+BoomaTimeShift::~BoomaTimeShift() {
+    Stop();
+    BoomaFree(_buffer);
+    BoomaFree(_lengths);
+}
+
+bool BoomaTimeShift::Start() {
+    if( _thread != nullptr ) {
+        return true;
+    }
+    if( !_reader->Start() ) {
+        HError("Upstream reader failed to start");
+        return false;
+    }
+
+    _running = true;
+    _finished = false;
+    _thread = new std::thread( [this]() { Capture(); } );
+    return true;
+}
+
+bool BoomaTimeShift::Stop() {
+    if( _thread == nullptr ) {
+        return true;
+    }
+
+    // Stop the upstream reader first, the capture thread may be waiting for it
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _running = false;
+    }
+    _changed.notify_all();
+    bool stopped = _reader->Stop();
+    _thread->join();
+    delete _thread;
+    _thread = nullptr;
+    return stopped;
+}
+
+void BoomaTimeShift::Capture() {
+    HLog("Time shift capture is running");
+    while( _running ) {
+        unsigned long head = _head.load(std::memory_order_relaxed);
+
+        // Input that is not live waits until the block it would overwrite has been read
+        if( !_live ) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _changed.wait(lock, [this, head]() { return !_running || head - _position < _blocks - TIMESHIFT_GUARD_BLOCKS; });
+            if( !_running ) {
+                break;
+            }
+        }
+
+        int read = _reader->Read(&_buffer[(head % _blocks) * _blocksize], _blocksize);
+        if( read <= 0 ) {
+            HLog("Upstream reader returned %d, ending time shift capture", read);
+            break;
+        }
+        _lengths[head % _blocks] = read;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _head.store(head + 1, std::memory_order_release);
+        }
+        _changed.notify_all();
+    }
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _finished = true;
+    }
+    _changed.notify_all();
+    HLog("Time shift capture has stopped");
+}
+
+int BoomaTimeShift::Read(int16_t* dest, size_t blocksize) {
+
+    // Make sure we are running, the processor may not have called Start()
+    if( _thread == nullptr && !Start() ) {
+        return 0;
+    }
+
+    if( blocksize != _blocksize ) {
+        HError("Requested blocksize %d differs from the time shift blocksize %d", blocksize, _blocksize);
+        return 0;
+    }
+
+    // Wait for the next block
+    unsigned long position = _position;
+    unsigned long block = position;
+    {
+        std::unique_lock<std::mutex> lock(_mutex);
+        _changed.wait(lock, [this, block]() { return block < _head.load(std::memory_order_acquire) || _finished; });
+        if( block >= _head.load(std::memory_order_acquire) ) {
+            return 0;
+        }
+    }
+
+    // If we have fallen more than the buffer length behind, skip to the oldest block we can safely
+    // read. Live input may lap the block while it is copied, then copy from the new oldest block
+    int length;
+    while( true ) {
+        unsigned long head = _head.load(std::memory_order_acquire);
+        if( head - block > _blocks - TIMESHIFT_GUARD_BLOCKS ) {
+            block = head - (_blocks - TIMESHIFT_GUARD_BLOCKS);
+        }
+        length = _lengths[block % _blocks];
+        memcpy((void*) dest, (void*) &_buffer[(block % _blocks) * _blocksize], length * sizeof(int16_t));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if( _head.load(std::memory_order_relaxed) - block < _blocks ) {
+            break;
+        }
+    }
+
+    // The stream jumped, restart the latency probes at the new position
+    if( block != _last + 1 && _latency != nullptr ) {
+        _latency->Reset(block * GetSecondsPerBlock());
+    }
+    _last = block;
+
+    // Replay every block while catching up, no faster than the requested speed
+    unsigned long next = block + 1;
+    if( _isShifted ) {
+        std::chrono::steady_clock::time_point rewound;
+        unsigned long rewoundPosition;
+        unsigned long head;
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            rewound = _rewound;
+            rewoundPosition = _rewoundPosition;
+            head = _head.load(std::memory_order_acquire);
+        }
+
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        double elapsed = std::chrono::duration<double>(now - rewound).count();
+        if( elapsed > 0 ) {
+            _catchUpSpeed = ((next - rewoundPosition) * GetSecondsPerBlock()) / elapsed;
+        }
+        if( next >= head ) {
+            HLog("Time shift has caught up with live input");
+            _isShifted = false;
+        } else if( _speed > 0 ) {
+            double due = (next - rewoundPosition) * GetSecondsPerBlock() / _speed;
+            std::this_thread::sleep_until(rewound + std::chrono::microseconds((long long) (due * 1000000)));
+        }
+    }
+
+    // Do not overwrite a rewind done while we were reading
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _position.compare_exchange_strong(position, next);
+    }
+    _changed.notify_all();
+    return length;
+}
+
+bool BoomaTimeShift::Rewind(int seconds) {
+    unsigned long head = _head.load(std::memory_order_acquire);
+    unsigned long blocks = (unsigned long) ceil((double) seconds * _rate * _channels / _blocksize);
+    unsigned long available = std::min(head, (unsigned long) (_blocks - TIMESHIFT_GUARD_BLOCKS));
+    if( blocks > available ) {
+        HLog("Only %lu blocks in the time shift buffer, rewinding %lu blocks instead of %lu", available, available, blocks);
+        blocks = available;
+    }
+    if( blocks == 0 ) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _rewound = std::chrono::steady_clock::now();
+        _rewoundPosition = head - blocks;
+        _catchUpSpeed = 0;
+        _isShifted = true;
+        _position = head - blocks;
+    }
+    HLog("Rewinding %d seconds (%lu blocks)", seconds, blocks);
+    return true;
+}
+
+void BoomaTimeShift::GoLive() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isShifted = false;
+        _position = _head.load(std::memory_order_acquire);
+    }
+    _changed.notify_all();
+    HLog("Time shift returned to live input");
+}
+
+double BoomaTimeShift::GetDelay() {
+    double behind = (double) _head.load(std::memory_order_acquire) - _position;
+    return behind <= 0 ? 0 : behind * _blocksize / (_rate * _channels);
+}
@@ -0,0 +1,48 @@
+#include "boomatrigger.h"
+
+BoomaTrigger::BoomaTrigger(int level, int hold, int preroll):
+    _level(level),
+    _hold((hold + preroll) * 1000),
+    _triggered(false),
+    _events(0) {
+
+    HLog("Creating dump trigger at S%d, holding for %d seconds with %d seconds preroll", level, hold, preroll);
+}
+
+bool BoomaTrigger::Arm(HBreaker<int16_t>* breaker, bool armed) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _breakers[breaker] = armed;
+    Apply(breaker, armed);
+    return armed;
+}
+
+void BoomaTrigger::Apply(HBreaker<int16_t>* breaker, bool armed) {
+    breaker->SetOff(!(armed && _triggered));
+}
+
+void BoomaTrigger::Update(int level) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+    bool triggered = _triggered;
+    if( level >= _level ) {
+        _lastActive = now;
+        triggered = true;
+    } else if( _triggered && now - _lastActive >= _hold ) {
+        triggered = false;
+    }
+    if( triggered == _triggered ) {
+        return;
+    }
+
+    _triggered = triggered;
+    if( _triggered ) {
+        _events++;
+        HLog("Dump trigger at S%d, starting dump (event %lu)", level, _events);
+    } else {
+        HLog("Signal has been below S%d for the hold time, stopping dump", _level);
+    }
+    for( std::map<HBreaker<int16_t>*, bool>::iterator it = _breakers.begin(); it != _breakers.end(); it++ ) {
+        Apply(it->first, it->second);
+    }
+}
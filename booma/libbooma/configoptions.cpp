@@ -6,6 +6,7 @@
 
 #include "booma.h"
 #include "configoptions.h"
+#include "boomasigmf.h"
 #include "language.h"
 
 void ConfigOptions::PrintUsage(bool showSecretSettings) {
@@ -25,7 +26,10 @@ void ConfigOptions::PrintUsage(bool showSecretSettings) {
     std::cout << tr("Use audio input source                                   -i AUDIO devicenumber") << std::endl;
     std::cout << tr("Use RTL-SDR input source (datatype defaults to IQ)       -i RTLSDR devicenumber") << std::endl;
     std::cout << tr("Use pcm file as input                                    -i PCM filename") << std::endl;
+    std::cout << tr("Use SigMF recording as input (restores rate and tuning)  -i PCM name.sigmf-data") << std::endl;
     std::cout << tr("Use wav file as input                                    -i WAV filename") << std::endl;
+    std::cout << tr("Playback speed for file input (default 0 = unthrottled)  -speed factor") << std::endl;
+    std::cout << tr("Loop file input                                          -loop") << std::endl;
     std::cout << tr("Use network input                                        -i NETWORK address dataport commandport") << std::endl;
     std::cout << tr("Set input datatype (required for NETWORK and PCM input)  -it REAl|IQ|I|Q") << std::endl;
     std::cout << tr("Set input type (required for NETWORK and PCM input)      -is AUDIO|RTLSDR") << std::endl;
@@ -48,8 +52,12 @@ void ConfigOptions::PrintUsage(bool showSecretSettings) {
     std::cout << tr("Output volume (default 5)                                -l volume") << std::endl;
     std::cout << tr("Dump rf input as pcm to file                             -p PCM (enable) | -p OFF (disable)") << std::endl;
     std::cout << tr("Dump rf input as wav to file (default)                   -p WAV (enable) | -p OFF (disable)") << std::endl;
+    std::cout << tr("Record rf input as SigMF with metadata                   -p SIGMF (enable) | -p OFF (disable)") << std::endl;
     std::cout << tr("Dump output audio as pcm to file                         -a PCM (enable) | -a OFF (disable)") << std::endl;
     std::cout << tr("Dump output audio as wav to file                         -a WAV (enable) | -a OFF (disable)") << std::endl;
+    std::cout << tr("Seconds kept before a dump is started (default 10)       -dpr seconds") << std::endl;
+    std::cout << tr("Only dump while the signal is at or above S-level        -trg level") << std::endl;
+    std::cout << tr("Keep triggered dumps going after the signal (default 5)  -trh seconds") << std::endl;
     std::cout << tr("Dump file suffix. If not set, a timestamp is used        -dfs suffix") << std::endl;
     std::cout << std::endl;
 
@@ -77,6 +85,28 @@ void ConfigOptions::PrintUsage(bool showSecretSettings) {
     std::cout << tr("==[Performance and quality (not persisted)]==") << std::endl;
     std::cout << tr("FIR filter size for decimation (default 51)              -ffs points") << std::endl;
     std::cout << tr("1.st IF filter width (default 10000)                     -ifw width") << std::endl;
+    std::cout << tr("Input thread with a ring of N blocks (default 0 = off)   -irt blocks") << std::endl;
+    std::cout << tr("Keep N seconds of input for rewinding (default 0 = off)  -ts seconds") << std::endl;
+    std::cout << tr("Max catch up speed, 0 = unlimited (default 2)            -tsc factor") << std::endl;
+    std::cout << tr("Dump writer thread with a ring of N blocks (0 = off)     -dt blocks") << std::endl;
+    std::cout << tr("Rotate threaded dumps at this size (default 0 = off)     -drs megabytes") << std::endl;
+    std::cout << tr("Rotate threaded dumps after this time (default 0 = off)  -drd seconds") << std::endl;
+    std::cout << tr("Decimation method (default FIR)                          -dm FIR|POLYPHASE|CIC") << std::endl;
+    std::cout << tr("Fast convolution above N taps (default 512, 0 = never)   -fct taps") << std::endl;
+    std::cout << tr("Channelizer channels for channel receivers (default 8)   -chn channels") << std::endl;
+    std::cout << tr("RF spectrum fft size (default 1024)                      -rffs size") << std::endl;
+    std::cout << tr("RF spectrum fft overlap (default 0)                      -rffo percent") << std::endl;
+    std::cout << tr("RF spectrum averaging (default 4)                        -rffa count") << std::endl;
+    std::cout << tr("AF spectrum fft size (default 256)                       -affs size") << std::endl;
+    std::cout << tr("AF spectrum fft overlap (default 0)                      -affo percent") << std::endl;
+    std::cout << tr("AF spectrum averaging (default 2)                        -affa count") << std::endl;
+    std::cout << tr("Stop spectrums when not read for N ms (default 2000)     -spto ms") << std::endl;
+    std::cout << tr("Blocksize, a power of 2 (default 4096)                   -bs size") << std::endl;
+    std::cout << tr("Low latency, small blocks and soundcard buffers          -ll") << std::endl;
+    std::cout << tr("Reserve N MB for working buffers (default 0 = heap)      -pool MB") << std::endl;
+    std::cout << tr("Use huge pages for the working buffer pool               -poolhp") << std::endl;
+    std::cout << tr("Lock the working buffer pool in memory                   -poollk") << std::endl;
+    std::cout << tr("Store filter designs in ~/.booma for the next run        -fcp") << std::endl;
     std::cout << std::endl;
 
     if( showSecretSettings ) {
@@ -98,6 +128,9 @@ void ConfigOptions::PrintUsage(bool showSecretSettings) {
         std::cout << tr("Use silence as input                                     -i SILENCE") << std::endl;
         std::cout << tr("Select /dev/null as output device.                       -o -1") << std::endl;
         std::cout << tr("Enable probes and halt after 100 blocks                  -x") << std::endl;
+        std::cout << tr("Enable per-block timing of the receiver chain            -bt") << std::endl;
+        std::cout << tr("Enable per-stage profiling of the receiver chain         -prof") << std::endl;
+        std::cout << tr("Enable latency measurement from input to output          -lat") << std::endl;
         std::cout << std::endl;
     } else {
         std::cout << tr("==[Debugging and internal settings best left untouched]==") << std::endl;
@@ -341,6 +374,27 @@ ConfigOptions::ConfigOptions(std::string appName, std::string appVersion, int ar
             continue;
         }
 
+        // Enable block timing
+        if( strcmp(argv[i], "-bt") == 0 ) {
+            HLog("Enabled block timing");
+            _values.at(_section)->_enableBlockTiming = true;
+            continue;
+        }
+
+        // Enable stage profiling
+        if( strcmp(argv[i], "-prof") == 0 ) {
+            HLog("Enabled stage profiling");
+            _values.at(_section)->_enableProfiling = true;
+            continue;
+        }
+
+        // Enable latency measurement
+        if( strcmp(argv[i], "-lat") == 0 ) {
+            HLog("Enabled latency measurement");
+            _values.at(_section)->_enableLatency = true;
+            continue;
+        }
+
         // Dump output as ... to file
         if( strcmp(argv[i], "-a") == 0 && i < argc - 1) {
             if( strcmp(argv[i + 1], "PCM") == 0 ) {
@@ -429,6 +483,19 @@ ConfigOptions::ConfigOptions(std::string appName, std::string appVersion, int ar
                 _values.at(_section)->_inputSourceDataType = (_values.at(_section)->_inputSourceDataType == NO_INPUT_SOURCE_DATA_TYPE ? REAL_INPUT_SOURCE_DATA_TYPE : _values.at(_section)->_inputSourceDataType);
                 _values.at(_section)->_isRemoteHead = false;
                 HLog("Input file %s", _values.at(_section)->_pcmFile.c_str());
+
+                // SigMF recordings carry their own samplerate, datatype and tuning
+                BoomaSigMFMetadata metadata;
+                if( _values.at(_section)->_pcmFile.find(".sigmf-") != std::string::npos && metadata.Read(_values.at(_section)->_pcmFile) ) {
+                    _values.at(_section)->_pcmFile = metadata.DataFile;
+                    _values.at(_section)->_inputSampleRate = metadata.SampleRate;
+                    _values.at(_section)->_inputSourceDataType = metadata.IsIq ? IQ_INPUT_SOURCE_DATA_TYPE : REAL_INPUT_SOURCE_DATA_TYPE;
+                    _values.at(_section)->_frequency = metadata.Frequency;
+                    if( metadata.Source != NO_INPUT_SOURCE_TYPE ) {
+                        _values.at(_section)->_originalInputSourceType = metadata.Source;
+                    }
+                    HLog("SigMF recording at %d, %s, frequency %ld", metadata.SampleRate, metadata.IsIq ? "IQ" : "REAL", metadata.Frequency);
+                }
             }
             else if( strcmp(argv[i + 1], "WAV") == 0 && i < argc - 2 ) {
                 _values.at(_section)->_inputSourceType = WAV_FILE;
@@ -596,6 +663,9 @@ ConfigOptions::ConfigOptions(std::string appName, std::string appVersion, int ar
             } else if( strcmp(argv[i + 1], "WAV") == 0 ) {
                 _values.at(_section)->_dumpRf = true;
                 _values.at(_section)->_dumpRfFileFormat = WAV;
+            } else if( strcmp(argv[i + 1], "SIGMF") == 0 ) {
+                _values.at(_section)->_dumpRf = true;
+                _values.at(_section)->_dumpRfFileFormat = SIGMF;
             } else {
                 _values.at(_section)->_dumpRf = false;
             }
@@ -708,6 +778,201 @@ ConfigOptions::ConfigOptions(std::string appName, std::string appVersion, int ar
             continue;
         }
 
+        // Decimation method
+        if( strcmp(argv[i], "-dm") == 0 && i < argc - 1) {
+            if( strcmp(argv[i + 1], "FIR") == 0 ) {
+                _values.at(_section)->_decimationMethod = FIR_DECIMATION;
+            } else if( strcmp(argv[i + 1], "POLYPHASE") == 0 ) {
+                _values.at(_section)->_decimationMethod = POLYPHASE_DECIMATION;
+            } else if( strcmp(argv[i + 1], "CIC") == 0 ) {
+                _values.at(_section)->_decimationMethod = CIC_DECIMATION;
+            } else {
+                std::cout << "Unknown decimation method '" << argv[i + 1] << "'" << std::endl;
+                exit(1);
+            }
+            HLog("Decimation method set to %d", _values.at(_section)->_decimationMethod);
+            i++;
+            continue;
+        }
+
+        // Fast convolution threshold
+        if( strcmp(argv[i], "-fct") == 0 && i < argc - 1) {
+            _values.at(_section)->_fastConvolutionThreshold = atoi(argv[i + 1]);
+            HLog("Fast convolution threshold set to %d taps", _values.at(_section)->_fastConvolutionThreshold);
+            i++;
+            continue;
+        }
+
+        // Channelizer channels
+        if( strcmp(argv[i], "-chn") == 0 && i < argc - 1) {
+            _values.at(_section)->_channelizerChannels = atoi(argv[i + 1]);
+            HLog("Channelizer channels set to %d", _values.at(_section)->_channelizerChannels);
+            i++;
+            continue;
+        }
+
+        // Spectrum settings
+        if( strcmp(argv[i], "-rffs") == 0 && i < argc - 1) {
+            _values.at(_section)->_rfFftSize = atoi(argv[i + 1]);
+            HLog("RF spectrum fft size set to %d", _values.at(_section)->_rfFftSize);
+            i++;
+            continue;
+        }
+        if( strcmp(argv[i], "-rffo") == 0 && i < argc - 1) {
+            _values.at(_section)->_rfFftOverlap = atoi(argv[i + 1]);
+            HLog("RF spectrum overlap set to %d%%", _values.at(_section)->_rfFftOverlap);
+            i++;
+            continue;
+        }
+        if( strcmp(argv[i], "-rffa") == 0 && i < argc - 1) {
+            _values.at(_section)->_rfFftAveraging = atoi(argv[i + 1]);
+            HLog("RF spectrum averaging set to %d", _values.at(_section)->_rfFftAveraging);
+            i++;
+            continue;
+        }
+        if( strcmp(argv[i], "-affs") == 0 && i < argc - 1) {
+            _values.at(_section)->_afFftSize = atoi(argv[i + 1]);
+            HLog("AF spectrum fft size set to %d", _values.at(_section)->_afFftSize);
+            i++;
+            continue;
+        }
+        if( strcmp(argv[i], "-affo") == 0 && i < argc - 1) {
+            _values.at(_section)->_afFftOverlap = atoi(argv[i + 1]);
+            HLog("AF spectrum overlap set to %d%%", _values.at(_section)->_afFftOverlap);
+            i++;
+            continue;
+        }
+        if( strcmp(argv[i], "-affa") == 0 && i < argc - 1) {
+            _values.at(_section)->_afFftAveraging = atoi(argv[i + 1]);
+            HLog("AF spectrum averaging set to %d", _values.at(_section)->_afFftAveraging);
+            i++;
+            continue;
+        }
+        if( strcmp(argv[i], "-spto") == 0 && i < argc - 1) {
+            _values.at(_section)->_spectrumTimeout = atoi(argv[i + 1]);
+            HLog("Spectrum timeout set to %d ms", _values.at(_section)->_spectrumTimeout);
+            i++;
+            continue;
+        }
+
+        // File input playback
+        if( strcmp(argv[i], "-speed") == 0 && i < argc - 1) {
+            _values.at(_section)->_inputFileSpeed = atof(argv[i + 1]) < 0 ? 0 : atof(argv[i + 1]);
+            HLog("Input file speed set to %f", _values.at(_section)->_inputFileSpeed);
+            i++;
+            continue;
+        }
+        if( strcmp(argv[i], "-loop") == 0 ) {
+            _values.at(_section)->_inputFileLoop = true;
+            HLog("Looping input file");
+            continue;
+        }
+
+        // Blocksize
+        if( strcmp(argv[i], "-bs") == 0 && i < argc - 1) {
+            int blocksize = atoi(argv[i + 1]);
+            if( blocksize < MIN_BLOCKSIZE || blocksize > MAX_BLOCKSIZE || (blocksize & (blocksize - 1)) != 0 ) {
+                HError("Blocksize %d must be a power of 2 from %d to %d, using %d", blocksize, MIN_BLOCKSIZE, MAX_BLOCKSIZE, _values.at(_section)->_blocksize);
+            } else {
+                _values.at(_section)->_blocksize = blocksize;
+                HLog("Blocksize set to %d", _values.at(_section)->_blocksize);
+            }
+            i++;
+            continue;
+        }
+        if( strcmp(argv[i], "-ll") == 0 ) {
+            _values.at(_section)->_blocksize = LOW_LATENCY_BLOCKSIZE;
+            HLog("Low latency, blocksize set to %d", _values.at(_section)->_blocksize);
+            continue;
+        }
+
+        // Working buffer pool
+        if( strcmp(argv[i], "-pool") == 0 && i < argc - 1) {
+            _values.at(_section)->_memoryPool = atoi(argv[i + 1]);
+            HLog("Working buffer pool set to %d MB", _values.at(_section)->_memoryPool);
+            i++;
+            continue;
+        }
+        if( strcmp(argv[i], "-poolhp") == 0 ) {
+            HLog("Using huge pages for the working buffer pool");
+            _values.at(_section)->_memoryPoolHugePages = true;
+            continue;
+        }
+        if( strcmp(argv[i], "-poollk") == 0 ) {
+            HLog("Locking the working buffer pool in memory");
+            _values.at(_section)->_memoryPoolLock = true;
+            continue;
+        }
+
+        // Input thread
+        if( strcmp(argv[i], "-irt") == 0 && i < argc - 1) {
+            _values.at(_section)->_inputThreadBlocks = atoi(argv[i + 1]);
+            HLog("Input thread ring size set to %d blocks", _values.at(_section)->_inputThreadBlocks);
+            i++;
+            continue;
+        }
+
+        // Filter design cache
+        if( strcmp(argv[i], "-fcp") == 0 ) {
+            _values.at(_section)->_persistFilterDesigns = true;
+            HLog("Storing filter designs");
+            continue;
+        }
+
+        // Time shift buffer
+        if( strcmp(argv[i], "-ts") == 0 && i < argc - 1) {
+            _values.at(_section)->_timeShift = atoi(argv[i + 1]);
+            HLog("Time shift buffer set to %d seconds", _values.at(_section)->_timeShift);
+            i++;
+            continue;
+        }
+        if( strcmp(argv[i], "-tsc") == 0 && i < argc - 1) {
+            _values.at(_section)->_timeShiftSpeed = atof(argv[i + 1]) <= 0 ? 0 : (atof(argv[i + 1]) < 1 ? 1 : atof(argv[i + 1]));
+            HLog("Time shift catch up speed set to %f", _values.at(_section)->_timeShiftSpeed);
+            i++;
+            continue;
+        }
+
+        // Dump preroll and signal level trigger
+        if( strcmp(argv[i], "-dpr") == 0 && i < argc - 1) {
+            _values.at(_section)->_dumpPreroll = atoi(argv[i + 1]) < 1 ? 1 : atoi(argv[i + 1]);
+            HLog("Dump preroll set to %d seconds", _values.at(_section)->_dumpPreroll);
+            i++;
+            continue;
+        }
+        if( strcmp(argv[i], "-trg") == 0 && i < argc - 1) {
+            _values.at(_section)->_triggerLevel = atoi(argv[i + 1]);
+            HLog("Dump trigger level set to S%d", _values.at(_section)->_triggerLevel);
+            i++;
+            continue;
+        }
+        if( strcmp(argv[i], "-trh") == 0 && i < argc - 1) {
+            _values.at(_section)->_triggerHold = atoi(argv[i + 1]);
+            HLog("Dump trigger hold set to %d seconds", _values.at(_section)->_triggerHold);
+            i++;
+            continue;
+        }
+
+        // Dump writer thread and file rotation
+        if( strcmp(argv[i], "-dt") == 0 && i < argc - 1) {
+            _values.at(_section)->_dumpThreadBlocks = atoi(argv[i + 1]);
+            HLog("Dump writer ring size set to %d blocks", _values.at(_section)->_dumpThreadBlocks);
+            i++;
+            continue;
+        }
+        if( strcmp(argv[i], "-drs") == 0 && i < argc - 1) {
+            _values.at(_section)->_dumpRotateSize = atoi(argv[i + 1]);
+            HLog("Dump rotation size set to %d MB", _values.at(_section)->_dumpRotateSize);
+            i++;
+            continue;
+        }
+        if( strcmp(argv[i], "-drd") == 0 && i < argc - 1) {
+            _values.at(_section)->_dumpRotateDuration = atoi(argv[i + 1]);
+            HLog("Dump rotation duration set to %d seconds", _values.at(_section)->_dumpRotateDuration);
+            i++;
+            continue;
+        }
+
         // Input filter width
         if( strcmp(argv[i], "-ifw") == 0 && i < argc - 1) {
             _values.at(_section)->_inputFilterWidth = atoi(argv[i + 1]);
@@ -1010,10 +1275,19 @@ void ConfigOptions::DumpConfigInfo() {
     }
 }
 
+ConfigOptions::ConfigOptions(ConfigOptions* other):
+    _isTransient(true) {
+
+    // Memory channels are shared with, and owned by, the original
+    _values.insert(std::pair<std::string, ConfigOptionValues*>(_section, new ConfigOptionValues(other->_values.at(other->_section))));
+}
+
 ConfigOptions::~ConfigOptions() {
-    WriteStoredConfig(CONFIGNAME, false);
-    for( std::vector<Channel*>::iterator it = _values.at(_section)->_channels.begin(); it != _values.at(_section)->_channels.end(); it++ ) {
-        delete (*it);
+    if( !_isTransient ) {
+        WriteStoredConfig(CONFIGNAME, false);
+        for( std::vector<Channel*>::iterator it = _values.at(_section)->_channels.begin(); it != _values.at(_section)->_channels.end(); it++ ) {
+            delete (*it);
+        }
     }
     for( std::map<std::string, ConfigOptionValues*>::iterator it = _values.begin(); it != _values.end(); it++ ) {
         delete ((*it).second);
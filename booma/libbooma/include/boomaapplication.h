@@ -9,6 +9,8 @@
 #include "boomainput.h"
 #include "boomareceiver.h"
 #include "boomaoutput.h"
+#include "boomachannelizer.h"
+#include "boomachannelreceiver.h"
 #include "booma.h"
 #include "option.h"
 
@@ -147,6 +149,12 @@ class BoomaApplication {
         bool GetDumpAudio();
         bool ToggleDumpAudio();
 
+        // With a signal level trigger (-trg), dumps are armed by the toggles and run while triggered
+        bool GetDumpTriggered();
+
+        // Blocks dropped by threaded dump writers (-dt) since the disk could not keep up
+        unsigned long GetDroppedDumpBlocks();
+
         int GetRfGain();
         bool SetRfGain(int gain);
         bool ChangeRfGain(int stepSize);
@@ -164,6 +172,38 @@ class BoomaApplication {
             return _opts->GetEnableProbes();
         }
 
+        // Block timing statistics, only available when block timing is enabled (-bt)
+        BoomaBlockTimer* GetBlockTimer() {
+            return _input != nullptr ? _input->GetBlockTimer() : nullptr;
+        }
+
+        // Blocks dropped by the input thread because the chain could not keep up
+        unsigned long GetDroppedInputBlocks() {
+            return _input != nullptr ? _input->GetDroppedBlocks() : 0;
+        }
+
+        // Per-stage timing statistics, only available when profiling is enabled (-prof)
+        std::vector<StageStatistics> GetStageStatistics();
+
+        // Latency from the input device to points in the chain, only available when enabled (-lat)
+        std::vector<LatencyStatistics> GetLatencyStatistics();
+
+        // Time shift (-ts), rewind and catch up faster than real time, or jump back to live input
+        bool Rewind(int seconds);
+        bool GoLive();
+        double GetTimeShiftDelay();
+        double GetTimeShiftMemoryPerMinute();
+        double GetTimeShiftCatchUpSpeed();
+
+        // File input playback, position and length in seconds (0 and false if the input is not a file)
+        bool SeekInput(double seconds);
+        double GetInputPosition();
+        double GetInputLength();
+        float GetInputSpeed();
+        bool SetInputSpeed(float speed);
+        bool GetInputLoop();
+        bool SetInputLoop(bool loop);
+
         // Public control functions that would require a receiver restart after modifications
         InputSourceType GetInputSourceType();
         bool SetInputSourceType(InputSourceType inputSourceType);
@@ -190,14 +230,28 @@ class BoomaApplication {
         void SetOutputAudioDevice(int card);
         void SetOutputFilename(std::string filename);
 
-        // Public reporting and setting functions for spectrum and signallevel
+        // Public reporting and setting functions for spectrum and signallevel.
+        // At most 'size' values are copied. When a sequence is given, the spectrum
+        // is only copied if there is a new spectrum since the last read (else 0 is returned)
         int GetSignalLevel();
         double GetSignalSum();
         int GetSignalMax();
         int GetRfFftSize();
-        int GetRfSpectrum(double* spectrum);
+        int GetRfSpectrum(double* spectrum, int size, unsigned long* sequence = nullptr);
         int GetAudioFftSize();
-        int GetAudioSpectrum(double* spectrum);
+        int GetAudioSpectrum(double* spectrum, int size, unsigned long* sequence = nullptr);
+
+        // Spectrum resolution, changed without reconfiguring the receiver
+        bool SetRfFftSize(int size);
+        int GetRfFftOverlap();
+        bool SetRfFftOverlap(int overlap);
+        int GetRfFftAveraging();
+        bool SetRfFftAveraging(int averaging);
+        bool SetAudioFftSize(int size);
+        int GetAudioFftOverlap();
+        bool SetAudioFftOverlap(int overlap);
+        int GetAudioFftAveraging();
+        bool SetAudioFftAveraging(int averaging);
 
         // Schedule
         HTimer GetSchedule();
@@ -233,6 +287,14 @@ class BoomaApplication {
         bool RemoveChannel(int id);
         bool UseChannel(int id);
 
+        // Channel receivers, receiving other frequencies within the input spectrum
+        // using a channelizer. Adding or removing a channel receiver reconfigures
+        // (and halts) the receiver chain
+        bool AddChannelReceiver(long int frequency, ReceiverModeType receiverModeType, std::string outputFilename = "");
+        bool RemoveChannelReceiver(long int frequency);
+        std::vector<long int> GetChannelReceivers();
+        int GetChannelReceiverSignalLevel(long int frequency);
+
         // Config sections
         std::vector<std::string> GetConfigSections();
         std::string GetConfigSection();
@@ -257,6 +319,13 @@ class BoomaApplication {
         BoomaReceiver* _receiver;
         BoomaOutput* _output;
 
+        // Channel receivers
+        BoomaSplitter* _channelSplitter;
+        BoomaChannelizer* _channelizer;
+        std::vector<BoomaChannelReceiver*> _channelReceivers;
+        HWriterConsumer<int16_t>* SetChannelReceivers(HWriterConsumer<int16_t>* previous);
+        void ResetChannelReceivers();
+
         // Disable copy constructor usage since that would
         // create multiple instances of the application core!
         BoomaApplication(const BoomaApplication&);
@@ -6,6 +6,7 @@
 #include "booma.h"
 #include "configoptions.h"
 #include "boomareceiver.h"
+#include "boomafirfilter.h"
 
 class BoomaAuroralReceiver : public BoomaReceiver {
 
@@ -15,7 +16,7 @@ class BoomaAuroralReceiver : public BoomaReceiver {
         HCombFilter<int16_t>* _humfilter;
 
         // Receiver
-        HFirFilter<int16_t>* _bandpass;
+        BoomaFirFilter* _bandpass;
 
         // Postprocessing
         HMovingAverageFilter<int16_t>* _averaging;
@@ -0,0 +1,43 @@
+#ifndef __BIQUADDESIGNER_H
+#define __BIQUADDESIGNER_H
+
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+/** Prototype used when designing cascaded biquad filters */
+enum BoomaBiQuadPrototype {
+    BUTTERWORTH = 0,
+    CHEBYSHEV = 1
+};
+
+/**
+ * Designs cascaded biquad bandpass filters at runtime, returning coefficients
+ * in the layout used by HCascadedBiQuadFilter and BoomaCascadedBiQuadFilter
+ * ('b0, b1, b2, a1, a2' per section, a1 and a2 negated).
+ *
+ * A lowpass prototype of order 'sections' is transformed to a bandpass with
+ * 2 * sections poles and mapped to z with the (prewarped) bilinear transform.
+ * Each section is normalized to unity gain at the center frequency.
+ *
+ * Designs are cached, the returned coefficients are owned by the designer
+ * and stay valid for the lifetime of the application.
+ */
+class BoomaBiQuadDesigner {
+
+    private:
+
+        typedef std::tuple<int, int, int, int, int, float> Key;
+
+        static std::map<Key, std::vector<float>> _cache;
+        static std::mutex _mutex;
+
+        static std::vector<float> Design(int rate, int center, int width, int sections, BoomaBiQuadPrototype prototype, float ripple);
+
+    public:
+
+        static float* Bandpass(int rate, int center, int width, int sections, BoomaBiQuadPrototype prototype = BUTTERWORTH, float ripple = 0.5);
+};
+
+#endif
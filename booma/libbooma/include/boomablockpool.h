@@ -0,0 +1,172 @@
+#ifndef __BLOCKPOOL_H
+#define __BLOCKPOOL_H
+
+#include <atomic>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "boomamemory.h"
+
+template <class T>
+class BoomaBlockPool;
+
+/**
+ * Reference counted block of samples taken from a BoomaBlockPool.
+ *
+ * A block that is shared (more than one reference) must be treated as
+ * read only, use BoomaBlockPool::MakeWritable() to get a private copy.
+ * The block goes back to the pool when the last reference is released.
+ */
+template <class T>
+class BoomaBlock {
+
+    friend class BoomaBlockPool<T>;
+
+    private:
+
+        T* _data;
+        int _length;
+        std::atomic<int> _references;
+        BoomaBlockPool<T>* _pool;
+
+        BoomaBlock(BoomaBlockPool<T>* pool, size_t blocksize):
+            _length(0),
+            _references(0),
+            _pool(pool) {
+
+            _data = BoomaAllocate<T>(blocksize);
+        }
+
+        ~BoomaBlock() {
+            BoomaFree(_data);
+        }
+
+    public:
+
+        T* GetData() {
+            return _data;
+        }
+
+        int GetLength() {
+            return _length;
+        }
+
+        void SetLength(int length) {
+            _length = length;
+        }
+
+        bool IsShared() {
+            return _references > 1;
+        }
+
+        void AddRef() {
+            _references++;
+        }
+
+        void Release() {
+            if( --_references == 0 ) {
+                _pool->Return(this);
+            }
+        }
+};
+
+/**
+ * Pool of blocks with a fixed blocksize. Blocks are allocated when the pool
+ * runs dry and are then reused, so that stages holding on to blocks do not
+ * allocate once the chain is running.
+ *
+ * There is one pool per blocksize, shared by all stages, and pools live
+ * for the lifetime of the application so blocks may outlive the stage
+ * that took them from the pool.
+ */
+template <class T>
+class BoomaBlockPool {
+
+    friend class BoomaBlock<T>;
+
+    private:
+
+        static std::map<size_t, BoomaBlockPool<T>*> _pools;
+        static std::mutex _poolsMutex;
+
+        size_t _blocksize;
+        std::mutex _mutex;
+        std::vector<BoomaBlock<T>*> _free;
+        int _allocated;
+
+        BoomaBlockPool(size_t blocksize):
+            _blocksize(blocksize),
+            _allocated(0) {}
+
+        void Return(BoomaBlock<T>* block) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _free.push_back(block);
+        }
+
+    public:
+
+        static BoomaBlockPool<T>* Get(size_t blocksize) {
+            std::lock_guard<std::mutex> lock(_poolsMutex);
+            typename std::map<size_t, BoomaBlockPool<T>*>::iterator it = _pools.find(blocksize);
+            if( it == _pools.end() ) {
+                it = _pools.insert(std::make_pair(blocksize, new BoomaBlockPool<T>(blocksize))).first;
+            }
+            return it->second;
+        }
+
+        // Block with one reference and undefined content
+        BoomaBlock<T>* Acquire() {
+            BoomaBlock<T>* block;
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                if( _free.empty() ) {
+                    block = new BoomaBlock<T>(this, _blocksize);
+                    _allocated++;
+                } else {
+                    block = _free.back();
+                    _free.pop_back();
+                }
+            }
+            block->_references = 1;
+            block->_length = _blocksize;
+            return block;
+        }
+
+        // Block with one reference holding a copy of 'length' samples
+        BoomaBlock<T>* Copy(T* src, int length) {
+            BoomaBlock<T>* block = Acquire();
+            memcpy((void*) block->_data, (void*) src, sizeof(T) * length);
+            block->_length = length;
+            return block;
+        }
+
+        // Returns the block itself if this is the only reference, otherwise
+        // a private copy (and the reference to the shared block is released)
+        BoomaBlock<T>* MakeWritable(BoomaBlock<T>* block) {
+            if( !block->IsShared() ) {
+                return block;
+            }
+            BoomaBlock<T>* copy = Copy(block->_data, block->_length);
+            block->Release();
+            return copy;
+        }
+
+        size_t GetBlocksize() {
+            return _blocksize;
+        }
+
+        int GetAllocated() {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return _allocated;
+        }
+};
+
+template <class T>
+std::map<size_t, BoomaBlockPool<T>*> BoomaBlockPool<T>::_pools;
+
+template <class T>
+std::mutex BoomaBlockPool<T>::_poolsMutex;
+
+#endif
@@ -0,0 +1,91 @@
+#ifndef __BLOCKRING_H
+#define __BLOCKRING_H
+
+#include <atomic>
+#include <cstring>
+
+#include "boomamemory.h"
+
+/**
+ * Lock-free ring of fixed size blocks with exactly one producer thread
+ * and one consumer thread.
+ *
+ * The producer fills the block returned by WriteBlock() and then commits
+ * it with Commit(), the consumer handles the block returned by ReadBlock()
+ * and then hands it back with Release(). No blocks are copied by the ring.
+ */
+template <class T>
+class BoomaBlockRing {
+
+    private:
+
+        T* _buffer;
+        int* _lengths;
+        size_t _blocks;
+        size_t _blocksize;
+
+        // Total number of blocks committed and released. Each is only
+        // ever written by one side so the ring is empty when they are
+        // equal and full when they differ by the ring size
+        std::atomic<size_t> _head;
+        std::atomic<size_t> _tail;
+
+    public:
+
+        BoomaBlockRing(size_t blocks, size_t blocksize):
+            _blocks(blocks),
+            _blocksize(blocksize),
+            _head(0),
+            _tail(0) {
+
+            _buffer = BoomaAllocate<T>(_blocks * _blocksize);
+            _lengths = BoomaAllocate<int>(_blocks);
+            memset((void*) _buffer, 0, sizeof(T) * _blocks * _blocksize);
+        }
+
+        ~BoomaBlockRing() {
+            BoomaFree(_buffer);
+            BoomaFree(_lengths);
+        }
+
+        // Producer: next free block, or nullptr if the ring is full
+        T* WriteBlock() {
+            size_t head = _head.load(std::memory_order_relaxed);
+            if( head - _tail.load(std::memory_order_acquire) >= _blocks ) {
+                return nullptr;
+            }
+            return &_buffer[(head % _blocks) * _blocksize];
+        }
+
+        // Producer: publish the block returned by WriteBlock()
+        void Commit(int length) {
+            size_t head = _head.load(std::memory_order_relaxed);
+            _lengths[head % _blocks] = length;
+            _head.store(head + 1, std::memory_order_release);
+        }
+
+        // Consumer: oldest committed block, or nullptr if the ring is empty
+        T* ReadBlock(int* length) {
+            size_t tail = _tail.load(std::memory_order_relaxed);
+            if( tail == _head.load(std::memory_order_acquire) ) {
+                return nullptr;
+            }
+            *length = _lengths[tail % _blocks];
+            return &_buffer[(tail % _blocks) * _blocksize];
+        }
+
+        // Consumer: hand the block returned by ReadBlock() back to the producer
+        void Release() {
+            _tail.store(_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        size_t GetBlocksize() {
+            return _blocksize;
+        }
+
+        size_t GetUsed() {
+            return _head.load(std::memory_order_acquire) - _tail.load(std::memory_order_acquire);
+        }
+};
+
+#endif
@@ -0,0 +1,75 @@
+#ifndef __BLOCKTIMER_H
+#define __BLOCKTIMER_H
+
+#include <chrono>
+#include <vector>
+
+#include <hardtapi.h>
+
+/**
+ * Reader placed between the input reader and the stream processor.
+ * The processor reads a block, then writes it through the entire
+ * receiver chain before reading the next block, so the time between
+ * two reads is the time it took to process one block end-to-end.
+ *
+ * Statistics are not synchronized, read them when the chain has halted.
+ */
+class BoomaBlockTimer : public HReader<int16_t> {
+
+    private:
+
+        HReader<int16_t>* _reader;
+
+        // Ring of block latencies (in microseconds)
+        std::vector<long> _latencies;
+        size_t _capacity;
+        size_t _next;
+
+        unsigned long _blocks;
+        unsigned long long _samples;
+        long _maxLatency;
+
+        bool _hasLastRead;
+        std::chrono::steady_clock::time_point _firstRead;
+        std::chrono::steady_clock::time_point _lastRead;
+
+    public:
+
+        BoomaBlockTimer(std::string id, HReader<int16_t>* reader, size_t capacity = 100000);
+
+        int Read(int16_t* dest, size_t blocksize);
+
+        bool Start() {
+            return _reader->Start();
+        }
+
+        bool Stop() {
+            return _reader->Stop();
+        }
+
+        bool Command(HCommand* command) {
+            return _reader->Command(command);
+        }
+
+        void Reset();
+
+        unsigned long GetBlocks() {
+            return _blocks;
+        }
+
+        unsigned long long GetSamples() {
+            return _samples;
+        }
+
+        long GetMaxLatency() {
+            return _maxLatency;
+        }
+
+        // Seconds between the first and the last read
+        double GetElapsed();
+
+        // Latency (in microseconds) below which 'percentile' percent of the blocks was processed
+        long GetLatencyPercentile(double percentile);
+};
+
+#endif
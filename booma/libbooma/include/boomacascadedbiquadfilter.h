@@ -0,0 +1,68 @@
+#ifndef __CASCADEDBIQUADFILTER_H
+#define __CASCADEDBIQUADFILTER_H
+
+#include <atomic>
+#include <mutex>
+
+#include <hardtapi.h>
+
+/**
+ * Cascaded biquad filter, a drop-in for HCascadedBiQuadFilter using the same
+ * coefficient layout: 5 coefficients 'b0, b1, b2, a1, a2' per section, with
+ * a1 and a2 already negated so that y = b0*x + b1*x1 + b2*x2 + a1*y1 + a2*y2.
+ *
+ * The samples stay in float through all sections. Each section is a direct
+ * form I, like the sections of HCascadedBiQuadFilter, so the filter history
+ * holds samples and not coefficient dependent state, and new coefficients
+ * take over from the same history. Four sections are run side by side in
+ * the lanes of a vector, each lane one sample behind the previous lane.
+ * Lanes are masked while the pipeline fills and drains at the start and end
+ * of each block, so the output is sample aligned with running the sections
+ * one after another. Cascades of more than four sections are run four
+ * sections at a time, unused lanes are set to pass-through.
+ *
+ * New coefficients are picked up by the dsp thread at the start of the next
+ * block.
+ *
+ * HCascadedBiQuadFilter converts to int16 between the sections, this filter
+ * only rounds the final output. The output is therefore not bit-exact with
+ * HCascadedBiQuadFilter, it is within one step of the exact result where
+ * the Hardt filter carries its truncation error through the later sections
+ * (see 'booma-bench -bq').
+ */
+class BoomaCascadedBiQuadFilter : public HFilter<int16_t> {
+
+    private:
+
+        int _groups;
+        size_t _blocksize;
+
+        // Coefficients and input/output history (x1, x2, y1, y2) per group of
+        // four sections, lane n is section n
+        float (*_coefficients)[5][4];
+        float (*_state)[4][4];
+
+        float* _buffer;
+
+        // Coefficients waiting to be picked up by Filter()
+        int _nextGroups;
+        float (*_next)[5][4];
+        std::mutex _mutex;
+        std::atomic<bool> _pending;
+
+        void Init(float* coefficients, int length, size_t blocksize);
+        void Apply();
+        void RunGroup(int group, float* samples);
+
+    public:
+
+        BoomaCascadedBiQuadFilter(std::string id, HWriterConsumer<int16_t>* consumer, float* coefficients, int length, size_t blocksize);
+        BoomaCascadedBiQuadFilter(std::string id, HWriter<int16_t>* writer, float* coefficients, int length, size_t blocksize);
+        ~BoomaCascadedBiQuadFilter();
+
+        void Filter(int16_t* src, int16_t* dest, size_t blocksize);
+
+        void SetCoefficients(float* coefficients, int length);
+};
+
+#endif
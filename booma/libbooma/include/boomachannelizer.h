@@ -0,0 +1,141 @@
+#ifndef __CHANNELIZER_H
+#define __CHANNELIZER_H
+
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include <hardtapi.h>
+
+#include "boomafft.h"
+
+/**
+ * A single channel taken out of a BoomaChannelizer. Delivers IQ samples at
+ * the channel samplerate, with the attached frequency moved to 0Hz.
+ * An output that has been moved outside the input spectrum delivers silence.
+ */
+class BoomaChannelizerOutput : public HWriterConsumer<int16_t> {
+
+    friend class BoomaChannelizer;
+
+    private:
+
+        HWriter<int16_t>* _writer;
+
+        // Filterbank channel and the remaining shift within that channel
+        int _channel;
+        double _stepRe;
+        double _stepIm;
+        double _phaseRe;
+        double _phaseIm;
+        bool _muted;
+
+        // Channel, shift and mute waiting to be picked up by the next Write()
+        int _nextChannel;
+        double _nextStepRe;
+        double _nextStepIm;
+        bool _nextMuted;
+        bool _update;
+
+        int16_t* _buffer;
+        size_t _blocksize;
+        size_t _length;
+
+        BoomaChannelizerOutput(size_t blocksize);
+
+    public:
+
+        ~BoomaChannelizerOutput();
+
+        void SetWriter(HWriter<int16_t>* writer) {
+            _writer = writer;
+        }
+
+        int GetChannel() {
+            return _channel;
+        }
+};
+
+/**
+ * Polyphase filterbank splitting IQ samples into N channels, spaced
+ * samplerate/N apart with channel 0 at 0Hz. One prototype lowpass filter
+ * is folded into N branches and a single N point FFT then produces one
+ * sample for every channel.
+ *
+ * The filterbank is 2 times oversampled, a new set of channel samples is
+ * produced for every N/2 input samples. The channels overlap so that any
+ * frequency can be attached with a channel bandwidth of samplerate/N
+ * around it, the remaining offset from the nearest channel center is
+ * removed by a small mixer in the channel output.
+ *
+ * The prototype filter should be a lowpass with a cutoff around
+ * 0.75 * samplerate/N and a length that is a multiple of N. It is scaled
+ * to unity gain.
+ */
+class BoomaChannelizer : public HWriter<int16_t> {
+
+    private:
+
+        int _rate;
+        int _channels;
+        int _decimation;
+        int _taps;
+        size_t _blocksize;
+
+        float* _coefficients;
+
+        // Sample windows (history + new samples) and the folded branch sums
+        float* _re;
+        float* _im;
+        float* _branchRe;
+        float* _branchIm;
+
+        BoomaFft* _fft;
+        unsigned long _outputs;
+
+        std::vector<BoomaChannelizerOutput*> _attached;
+        std::mutex _mutex;
+        std::atomic<bool> _pending;
+
+        void Apply();
+
+    public:
+
+        BoomaChannelizer(std::string id, HWriterConsumer<int16_t>* consumer, int rate, int channels, float* coefficients, int taps, size_t blocksize);
+        ~BoomaChannelizer();
+
+        int Write(int16_t* src, size_t blocksize);
+
+        bool Start();
+        bool Stop();
+        bool Command(HCommand* command);
+
+        // Attach a new output at 'offset' Hz from the center of the input spectrum
+        BoomaChannelizerOutput* Attach(int offset);
+
+        // Move an attached output to a new offset. The output is muted if the
+        // offset is outside the input spectrum. Takes effect at the next Write()
+        bool SetOffset(BoomaChannelizerOutput* output, int offset);
+
+        bool IsOffsetSupported(int offset) {
+            return IsOffsetSupported(offset, _rate, _channels);
+        }
+
+        static bool IsOffsetSupported(int offset, int rate, int channels) {
+            return offset >= -(rate / 2) + (rate / channels / 2) && offset <= (rate / 2) - (rate / channels / 2);
+        }
+
+        int GetChannels() {
+            return _channels;
+        }
+
+        int GetChannelSpacing() {
+            return _rate / _channels;
+        }
+
+        int GetChannelRate() {
+            return _rate / _decimation;
+        }
+};
+
+#endif
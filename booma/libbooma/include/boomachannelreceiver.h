@@ -0,0 +1,57 @@
+#ifndef __CHANNELRECEIVER_H
+#define __CHANNELRECEIVER_H
+
+#include <hardtapi.h>
+
+#include "configoptions.h"
+#include "boomachannelizer.h"
+#include "boomareceiver.h"
+#include "boomaoutput.h"
+
+/**
+ * Receiver and output running on a single channel from the channelizer.
+ * Each channel receiver has its own transient copy of the configuration,
+ * running at the channel samplerate, so that it can use another receiver
+ * type and output than the main receiver.
+ */
+class BoomaChannelReceiver {
+
+    private:
+
+        long int _frequency;
+        ReceiverModeType _receiverModeType;
+        std::string _outputFilename;
+
+        ConfigOptions* _opts;
+        BoomaChannelizerOutput* _channel;
+        BoomaReceiver* _receiver;
+        BoomaOutput* _output;
+
+    public:
+
+        BoomaChannelReceiver(long int frequency, ReceiverModeType receiverModeType, std::string outputFilename);
+        ~BoomaChannelReceiver();
+
+        // Build receiver and output on a new channel from the channelizer
+        void Build(ConfigOptions* opts, BoomaChannelizer* channelizer);
+
+        // Delete receiver and output, the channel is owned by the channelizer
+        void Reset();
+
+        // Follow the frequency of the main receiver
+        bool SetFrequency(ConfigOptions* opts, BoomaChannelizer* channelizer);
+
+        long int GetFrequency() {
+            return _frequency;
+        }
+
+        ReceiverModeType GetReceiverModeType() {
+            return _receiverModeType;
+        }
+
+        int GetSignalLevel() {
+            return _output != nullptr ? _output->GetSignalLevel() : 0;
+        }
+};
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef __CICCOMPENSATION_H
+#define __CICCOMPENSATION_H
+
+/**
+ * Kaiser windowed FIR lowpass with an inverse-sinc passband, correcting the
+ * droop of a preceeding CIC decimator.
+ *
+ * The rate is the samplerate at the output of the CIC decimator, which is
+ * the rate the compensation filter runs at. The cutoff is the center of the
+ * transition band.
+ */
+class BoomaCicCompensation {
+
+    private:
+
+        int _factor;
+        int _stages;
+        int _cutoff;
+        int _rate;
+        int _taps;
+        float _attenuation;
+
+        double CicResponse(double frequency);
+        static double Bessel(double x);
+
+    public:
+
+        BoomaCicCompensation(int factor, int stages, int cutoff, int rate, int taps, float attenuation);
+
+        float* Calculate();
+
+        // Number of taps (odd) needed for a Kaiser window to go from the passband
+        // to 'attenuation' dB at the stopband edge
+        static int GetTaps(int rate, int passband, int stopband, float attenuation);
+};
+
+#endif
@@ -0,0 +1,65 @@
+#ifndef __CICDECIMATOR_H
+#define __CICDECIMATOR_H
+
+#include <hardtapi.h>
+
+/**
+ * Multiplier-free cascaded integrator-comb (CIC) decimator for real or
+ * IQ (interleaved) samples, with differential delay 1.
+ *
+ * The integrators run in 64 bit modular arithmetic, the register growth
+ * is 'stages * log2(factor)' bits on top of the 16 bit input. The output
+ * is scaled back down by the CIC gain 'factor ^ stages'.
+ *
+ * The passband droop must be corrected by a following compensation FIR,
+ * see BoomaCicCompensation.
+ */
+class BoomaCicDecimator : public HReader<int16_t> {
+
+    private:
+
+        HReader<int16_t>* _reader;
+        int _factor;
+        int _stages;
+        size_t _blocksize;
+        int _channels;
+        double _scale;
+
+        int16_t* _input;
+
+        // Integrator and comb state per channel and stage
+        uint64_t** _integrators;
+        uint64_t** _combs;
+
+    public:
+
+        BoomaCicDecimator(std::string id, HReader<int16_t>* reader, int factor, int stages, size_t blocksize, bool isIq);
+        ~BoomaCicDecimator();
+
+        int Read(int16_t* dest, size_t blocksize);
+
+        bool Start() {
+            return _reader->Start();
+        }
+
+        bool Stop() {
+            return _reader->Stop();
+        }
+
+        bool Command(HCommand* command) {
+            return _reader->Command(command);
+        }
+
+        // Number of bits needed in the integrators
+        static int GetRegisterBits(int factor, int stages);
+
+        // Number of stages needed to suppress the aliases folding onto the
+        // passband edge by 'attenuation' dB. The edge is relative to the output rate
+        static int GetStages(int factor, double edge, float attenuation);
+
+        // Factor to leave for the final FIR decimator, so that the CIC decimator
+        // stops at 4-8 times the output rate whenever the factor allows it
+        static int GetFinalFactor(int factor);
+};
+
+#endif
@@ -6,7 +6,10 @@
 #include "booma.h"
 #include "configoptions.h"
 #include "boomareceiver.h"
+#include "boomacascadedbiquadfilter.h"
+#include "boomabiquaddesigner.h"
 #include "boomainput.h"
+#include "boomamixer.h"
 
 class BoomaCwReceiver : public BoomaReceiver {
 
@@ -15,22 +18,20 @@ class BoomaCwReceiver : public BoomaReceiver {
         // Preprocessing
         HHumFilter<int16_t>* _humfilter;
         HIq2IConverter<int16_t>* _iq2IConverter;
-        HIqMultiplier<int16_t>* _iqMultiplier;
+        BoomaIqMixer* _iqMultiplier;
         HBiQuadFilter<HBandpassBiQuad<int16_t>, int16_t>* _preselect;
         HGain<int16_t>* _passbandGain;
-        HMultiplier<int16_t>* _ifMixer;
+        BoomaMixer* _ifMixer;
 
         // Receiver
-        HCascadedBiQuadFilter<int16_t>* _ifFilter;
-        HMultiplier<int16_t>* _beatToneMixer;
-        HCascadedBiQuadFilter<int16_t>* _postSelect;
+        BoomaCascadedBiQuadFilter* _ifFilter;
+        BoomaMixer* _beatToneMixer;
+        BoomaCascadedBiQuadFilter* _postSelect;
 
         // Postprocessing
         // ...(empty)...
 
-        static float _bandpassCoeffs[6][20];
         static int _bandpassWidths[];
-        static float _cwCoeffs[];
 
         bool IsDataTypeSupported(InputSourceDataType datatype) {
             switch( datatype ) {
@@ -56,15 +57,26 @@ class BoomaCwReceiver : public BoomaReceiver {
             return GetOption("Ifshift") * (_bandpassWidths[GetOption("Bandwidth")] / 4);
         }
 
+        int GetIfFrequency(ConfigOptions* opts) {
+            // 6KHz at 48KHz
+            return opts->GetOutputSampleRate() / 8;
+        }
+
+        float* GetIfFilterCoefficients(ConfigOptions* opts) {
+            // The passband must stay clear of 0Hz, so at low samplerates the widest filters are narrowed
+            int width = _bandpassWidths[GetOption("Bandwidth")];
+            return BoomaBiQuadDesigner::Bandpass(opts->GetOutputSampleRate(), GetIfFrequency(opts), width < GetIfFrequency(opts) ? width : GetIfFrequency(opts), 4);
+        }
+
         long GetDefaultFrequency(ConfigOptions* opts) {
             return (opts->GetOutputSampleRate() / 2) / 2;
         }
 
         bool IsFrequencySupported(ConfigOptions* opts, long frequency) {
             if( opts->GetInputSourceDataType() == REAL_INPUT_SOURCE_DATA_TYPE ) {
-                // This receiver will not tune lower than 6KHz since we use 6KHz as
-                // the internal IF in the heterodyne mixing stage.
-                return frequency < opts->GetOutputSampleRate() / 2 && (frequency > 6000);
+                // This receiver will not tune lower than the IF frequency since
+                // that is used in the heterodyne mixing stage.
+                return frequency < opts->GetOutputSampleRate() / 2 && (frequency > GetIfFrequency(opts));
             } else {
                 // With an rtlsdr source, the frequency can be almost anything
                 return frequency >= 0;
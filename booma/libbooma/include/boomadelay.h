@@ -0,0 +1,60 @@
+#ifndef __DELAY_H
+#define __DELAY_H
+
+#include <hardtapi.h>
+
+#include "boomablockpool.h"
+#include "boomasplitter.h"
+
+/**
+ * Delay line, a drop-in for HDelay, holding references to pooled blocks
+ * instead of copying samples in and out of a ring buffer.
+ *
+ * When attached to a BoomaSplitter, the delay keeps a reference to the
+ * block shared by the splitter, so delaying a block costs no copying at
+ * all. Silence is written until the delay line has been filled.
+ *
+ * The rate is given in samples per second, so interleaved IQ input must
+ * pass the frame rate times the number of channels.
+ */
+class BoomaDelay : public HWriter<int16_t>, public HWriterConsumer<int16_t>, public BoomaBlockWriter {
+
+    private:
+
+        HWriter<int16_t>* _writer;
+        BoomaBlockPool<int16_t>* _pool;
+
+        BoomaBlock<int16_t>** _blocks;
+        int _length;
+        int _position;
+
+        void Init(size_t blocksize, int rate, int seconds);
+
+    public:
+
+        BoomaDelay(std::string id, HWriterConsumer<int16_t>* consumer, size_t blocksize, int rate, int seconds);
+        BoomaDelay(std::string id, BoomaSplitter* splitter, size_t blocksize, int rate, int seconds);
+        ~BoomaDelay();
+
+        int Write(int16_t* src, size_t blocksize);
+
+        int WriteBlock(BoomaBlock<int16_t>* block);
+
+        void SetWriter(HWriter<int16_t>* writer) {
+            _writer = writer;
+        }
+
+        bool Start() {
+            return _writer != nullptr ? _writer->Start() : true;
+        }
+
+        bool Stop() {
+            return _writer != nullptr ? _writer->Stop() : true;
+        }
+
+        bool Command(HCommand* command) {
+            return _writer != nullptr ? _writer->Command(command) : true;
+        }
+};
+
+#endif
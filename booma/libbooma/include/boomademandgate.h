@@ -0,0 +1,60 @@
+#ifndef __DEMANDGATE_H
+#define __DEMANDGATE_H
+
+#include <atomic>
+#include <chrono>
+
+#include <hardtapi.h>
+
+/**
+ * Writer that only passes samples on to the next stage while someone is
+ * consuming the results of the branch it feeds, so that branches such as
+ * the spectrum calculation cost nothing when nobody is looking.
+ *
+ * Consumers call Poll() each time they read the results, and the gate stays
+ * open for 'timeout' milliseconds after the last poll. The first poll after
+ * a quiet period opens the gate, so the first results arrive a little later.
+ * A timeout of 0 keeps the gate open at all times.
+ */
+class BoomaDemandGate : public HWriter<int16_t>, public HWriterConsumer<int16_t> {
+
+    private:
+
+        std::string _name;
+        HWriter<int16_t>* _writer;
+
+        int _timeout;
+        std::atomic<long long> _lastPoll;
+        bool _isOpen;
+
+        static long long Now();
+
+    public:
+
+        BoomaDemandGate(std::string id, HWriterConsumer<int16_t>* consumer, int timeout);
+
+        int Write(int16_t* src, size_t blocksize);
+
+        void SetWriter(HWriter<int16_t>* writer) {
+            _writer = writer;
+        }
+
+        bool Start() {
+            return _writer != nullptr ? _writer->Start() : true;
+        }
+
+        bool Stop() {
+            return _writer != nullptr ? _writer->Stop() : true;
+        }
+
+        bool Command(HCommand* command) {
+            return _writer != nullptr ? _writer->Command(command) : true;
+        }
+
+        // Keep the gate open for another 'timeout' milliseconds
+        void Poll();
+
+        bool IsOpen();
+};
+
+#endif
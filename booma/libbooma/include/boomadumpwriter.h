@@ -0,0 +1,79 @@
+#ifndef __DUMPWRITER_H
+#define __DUMPWRITER_H
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include <hardtapi.h>
+
+#include "boomablockring.h"
+
+/**
+ * Dump writer, a drop-in for HWavWriter and HFileWriter for long unattended
+ * recordings.
+ *
+ * Blocks are handed to a separate I/O thread through a lock-free block ring
+ * so that a slow disk never stalls the processing thread. If the ring is
+ * full the block is dropped and counted. File space is preallocated ahead
+ * of the writes, and the dump rotates to a new file ('name_001.wav',
+ * 'name_002.wav', ...) when a file reaches 'rotateBytes' or 'rotateSeconds'
+ * (0 disables either limit).
+ *
+ * Without a consumer, the writer is fed by another writer through Queue(),
+ * writing raw samples to 'filename' + 'extension' without rotation.
+ */
+class BoomaDumpWriter : public HWriter<int16_t> {
+
+    private:
+
+        std::string _filename;
+        std::string _extension;
+        bool _isWav;
+        int _rate;
+        int _channels;
+        unsigned long _rotateBytes;
+        unsigned long _rotateSeconds;
+
+        BoomaBlockRing<int16_t>* _ring;
+
+        std::thread* _thread;
+        std::atomic<bool> _running;
+        std::atomic<unsigned long> _dropped;
+
+        // Current file, only touched by the I/O thread
+        int _fd;
+        int _sequence;
+        unsigned long _bytes;
+        unsigned long _allocated;
+
+        void Init(size_t blocksize, int blocks);
+        void Consume();
+        bool Open();
+        void Close();
+        void Append(int16_t* block, int length);
+
+    public:
+
+        BoomaDumpWriter(std::string id, std::string filename, bool isWav, HWriterConsumer<int16_t>* consumer, int rate, int channels, size_t blocksize, int blocks, int rotateMegabytes, int rotateSeconds);
+        BoomaDumpWriter(std::string id, std::string filename, std::string extension, int rate, int channels, size_t blocksize, int blocks);
+        ~BoomaDumpWriter();
+
+        int Write(int16_t* src, size_t blocksize);
+
+        // Returns false if the block was dropped
+        bool Queue(int16_t* src, size_t blocksize);
+
+        bool Start();
+        bool Stop();
+
+        bool Command(HCommand* command) {
+            return true;
+        }
+
+        unsigned long GetDroppedBlocks() {
+            return _dropped;
+        }
+};
+
+#endif
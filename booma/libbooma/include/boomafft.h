@@ -0,0 +1,36 @@
+#ifndef __FFT_H
+#define __FFT_H
+
+/**
+ * In-place iterative radix-2 complex FFT on split real and imaginary
+ * arrays, with precalculated per-stage twiddle factors so that the
+ * butterflies run over contiguous memory. The inverse transform is not
+ * scaled.
+ */
+class BoomaFft {
+
+    private:
+
+        int _size;
+        int* _reversed;
+        float* _twiddlesRe;
+        float* _twiddlesIm;
+
+    public:
+
+        BoomaFft(int size);
+        ~BoomaFft();
+
+        void Forward(float* re, float* im);
+
+        // The inverse transform is the forward transform with real and imaginary parts swapped
+        void Inverse(float* re, float* im) {
+            Forward(im, re);
+        }
+
+        int GetSize() {
+            return _size;
+        }
+};
+
+#endif
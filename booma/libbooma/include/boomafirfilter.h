@@ -0,0 +1,110 @@
+#ifndef __FIRFILTER_H
+#define __FIRFILTER_H
+
+#include <atomic>
+#include <mutex>
+
+#include <hardtapi.h>
+
+#include "boomafft.h"
+
+/** Multiply-accumulate kernel used by the FIR filter */
+enum BoomaFirKernel {
+    FIR_KERNEL_AUTO = 0,
+    FIR_KERNEL_SCALAR = 1,
+    FIR_KERNEL_SSE2 = 2,
+    FIR_KERNEL_AVX2 = 3,
+    FIR_KERNEL_NEON = 4
+};
+
+/**
+ * Int16 FIR filter for real or IQ (interleaved) samples, a drop-in for
+ * HFirFilter and HIqFirFilter.
+ *
+ * The coefficients are converted to fixed point with the largest shift
+ * that can not overflow the 32 bit accumulators, and the filter is padded
+ * with zeroes to a multiple of 16 taps so that the SIMD kernels need no
+ * tail handling. The fastest kernel supported by the cpu is selected at
+ * runtime unless a specific kernel is requested.
+ *
+ * Filters with more taps than the fast convolution threshold (if not 0) are
+ * run as overlap-save fast convolution instead. The samples are treated as
+ * complex - I and Q for IQ signals, the first and second half of the block
+ * for real signals - so that each segment needs just one forward and one
+ * inverse complex FFT.
+ *
+ * SetCoefficients() may be called from another thread than Filter(). The new
+ * filter is built on the side and swapped in at the start of the next block.
+ */
+class BoomaFirFilter : public HFilter<int16_t> {
+
+    private:
+
+        bool _isIq;
+        int _channels;
+        BoomaFirKernel _kernel;
+        int32_t (*_dot)(const int16_t* coefficients, const int16_t* samples, int length);
+
+        size_t _blocksize;
+        int _threshold;
+
+        // Everything that changes with the coefficients
+        struct State {
+            int taps;
+            bool fast;
+
+            // Reversed fixed point coefficients, padded at the front, and per-channel
+            // sample buffers with 'length - 1' samples history followed by the new samples
+            int16_t* coefficients;
+            int length;
+            int shift;
+            int16_t** buffers;
+
+            // Fast convolution, filter spectrum and per-channel buffers with 'taps - 1' samples history
+            BoomaFft* fft;
+            float* spectrumRe;
+            float* spectrumIm;
+            float* segmentRe;
+            float* segmentIm;
+            float** samples;
+        };
+
+        // Active state, and the next state waiting to be swapped in
+        State* _state;
+        State* _next;
+        std::mutex _mutex;
+        std::atomic<bool> _pending;
+        std::atomic<bool> _fast;
+
+        void Init(float* coefficients, int taps, size_t blocksize, bool isIq, int threshold, BoomaFirKernel kernel);
+        State* Build(float* coefficients, int taps);
+        void Release(State* state);
+        void Apply();
+
+        void FilterDirect(State* state, int16_t* src, int16_t* dest);
+        void FilterFast(State* state, int16_t* src, int16_t* dest);
+
+    public:
+
+        BoomaFirFilter(std::string id, HWriterConsumer<int16_t>* consumer, float* coefficients, int taps, size_t blocksize, bool isIq = false, int fastConvolutionThreshold = 0, BoomaFirKernel kernel = FIR_KERNEL_AUTO);
+        BoomaFirFilter(std::string id, HWriter<int16_t>* writer, float* coefficients, int taps, size_t blocksize, bool isIq = false, int fastConvolutionThreshold = 0, BoomaFirKernel kernel = FIR_KERNEL_AUTO);
+        ~BoomaFirFilter();
+
+        void Filter(int16_t* src, int16_t* dest, size_t blocksize);
+
+        void SetCoefficients(float* coefficients, int taps);
+
+        BoomaFirKernel GetKernel() {
+            return _kernel;
+        }
+
+        bool IsFastConvolution() {
+            return _fast;
+        }
+
+        static bool IsSupported(BoomaFirKernel kernel);
+        static BoomaFirKernel GetBestKernel();
+        static const char* GetKernelName(BoomaFirKernel kernel);
+};
+
+#endif
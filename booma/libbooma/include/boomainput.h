@@ -5,6 +5,24 @@
 #include "configoptions.h"
 #include "boomaexception.h"
 #include "boomainputexception.h"
+#include "boomablocktimer.h"
+#include "boomaprofiler.h"
+#include "boomalatency.h"
+#include "boomathreadedreader.h"
+#include "boomapolyphasedecimator.h"
+#include "boomacicdecimator.h"
+#include "boomaciccompensation.h"
+#include "boomarationalresampler.h"
+#include "boomafirfilter.h"
+#include "boomaspectrum.h"
+#include "boomademandgate.h"
+#include "boomasplitter.h"
+#include "boomadelay.h"
+#include "boomamappedfilereader.h"
+#include "boomasigmf.h"
+#include "boomadumpwriter.h"
+#include "boomatimeshift.h"
+#include "boomamixer.h"
 #include "booma.h"
 
 class BoomaInput {
@@ -15,40 +33,51 @@ public:
 
         // Input and processor
         HReader<int16_t>* _inputReader;
+        BoomaMappedFileReader* _fileReader;
         HStreamProcessor<int16_t>* _streamProcessor;
         HNetworkProcessor<int16_t>* _networkProcessor;
 
+        // Optional block timing and stage profiling
+        BoomaBlockTimer* _blockTimer;
+        BoomaProfiler* _profiler;
+        BoomaLatency* _latency;
+
+        // Optional input thread
+        BoomaThreadedReader* _threadedReader;
+
+        // Optional time shift buffer
+        BoomaTimeShift* _timeShift;
+
         // Decimation
         HGain<int16_t>* _decimatorGain;
         HAgc<int16_t>* _decimatorAgc;
-        HIqMultiplier<int16_t>* _ifMultiplier;
+        BoomaIqMixer* _ifMultiplier;
         HIqFirDecimator<int16_t>* _iqFirDecimator;
         HIqDecimator<int16_t>* _iqDecimator;
         HFirDecimator<int16_t>* _firDecimator;
         HDecimator<int16_t>* _decimator;
+        BoomaPolyphaseDecimator* _polyphaseDecimator;
+        BoomaCicDecimator* _cicDecimator;
+        BoomaRationalResampler* _rationalResampler;
 
         // Preamp
         HGain<int16_t>* _preamp;
 
         // Input filtering
-        HIqFirFilter<int16_t>* _inputIqFirFilter;
-        HFirFilter<int16_t>* _inputFirFilter;
+        BoomaFirFilter* _inputIqFirFilter;
+        BoomaFirFilter* _inputFirFilter;
 
         // Dumping rf input
-        HSplitter<int16_t>* _rfSplitter;
+        BoomaSplitter* _rfSplitter;
         HBreaker<int16_t>* _rfBreaker;
         HBufferedWriter<int16_t>* _rfBuffer;
         HWriter<int16_t>* _rfWriter;
-        HDelay<int16_t>* _rfDelay;
+        BoomaSigMFWriter* _rfRecorder;
+        BoomaDelay* _rfDelay;
 
         // RF spectrum reporting
-        HFftOutput<int16_t>* _rfFft;
-        HCustomWriter<HFftResults>* _rfFftWriter;
-        int RfFftCallback(HFftResults* result, size_t length);
-        HRectangularWindow<int16_t>* _rfFftWindow;
-        double* _rfSpectrum;
-        int _rfFftSize;
-        int _rfSpectrumSize;
+        BoomaDemandGate* _rfFftGate;
+        BoomaSpectrum* _rfFft;
         HGain<int16_t>* _rfFftGain;
 
         // Final consumer
@@ -60,8 +89,12 @@ public:
 
         HReader<int16_t>* SetInputReader(ConfigOptions* opts);
         void SetReaderFrequencies(ConfigOptions *opts, int frequency);
-        bool GetDecimationRate(int inputRate, int outputRate, int* first, int* second);
+        bool GetDecimationRate(int inputRate, int outputRate, int blocksize, int* first, int* second);
+        HReader<int16_t>* SetResampling(ConfigOptions* opts, HReader<int16_t>* previous, bool isIq);
+        HReader<int16_t>* SetDecimatorGain(ConfigOptions* opts, HReader<int16_t>* previous);
         HReader<int16_t>* SetDecimation(ConfigOptions* opts, HReader<int16_t>* reader);
+        HReader<int16_t>* SetInputThread(ConfigOptions* opts, HReader<int16_t>* previous);
+        HReader<int16_t>* SetTimeShift(ConfigOptions* opts, HReader<int16_t>* previous, int channels);
         HWriterConsumer<int16_t>* SetInputFilter(ConfigOptions* options, HWriterConsumer<int16_t>* previous);
         HWriterConsumer<int16_t>* SetShift(ConfigOptions* options, HWriterConsumer<int16_t>* previous);
         HWriterConsumer<int16_t>* SetPreamp(ConfigOptions* opts, HWriterConsumer<int16_t>* previous);
@@ -85,9 +118,44 @@ public:
 
         void Run(int blocks = 0);
 
+        BoomaBlockTimer* GetBlockTimer() {
+            return _blockTimer;
+        }
+
+        unsigned long GetDroppedBlocks() {
+            return _threadedReader != nullptr ? _threadedReader->GetDroppedBlocks() : 0;
+        }
+
+        // Time shift buffer, nullptr if not enabled
+        BoomaTimeShift* GetTimeShift() {
+            return _timeShift;
+        }
+
+        std::vector<StageStatistics> GetStageStatistics() {
+            return _profiler->GetStatistics();
+        }
+
+        BoomaLatency* GetLatency() {
+            return _latency;
+        }
+
+        // SigMF rf recorder, nullptr if rf is not dumped as SigMF
+        BoomaSigMFWriter* GetRfRecorder() {
+            return _rfRecorder;
+        }
+
+        // File input, nullptr if the input is not a file
+        BoomaMappedFileReader* GetFileReader() {
+            return _fileReader;
+        }
+
         void Halt();
 
         bool SetDumpRf(bool enabled);
+        HBreaker<int16_t>* GetRfBreaker() {
+            return _rfBreaker;
+        }
+        unsigned long GetDroppedDumpBlocks();
 
         bool SetFrequency(ConfigOptions* opts, int frequency);
 
@@ -99,8 +167,9 @@ public:
 
         bool SetPreampLevel(ConfigOptions* opts, int level);
 
-        int GetRfSpectrum(double* spectrum);
+        int GetRfSpectrum(double* spectrum, int size, unsigned long* sequence = nullptr);
         int GetRfFftSize();
+        bool SetRfSpectrum(int size, int overlap, int averaging);
 };
 
 #endif
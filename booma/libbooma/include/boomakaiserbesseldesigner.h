@@ -0,0 +1,57 @@
+#ifndef __KAISERBESSELDESIGNER_H
+#define __KAISERBESSELDESIGNER_H
+
+#include <list>
+#include <map>
+#include <ostream>
+#include <mutex>
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+/**
+ * Cached Kaiser-Bessel FIR designs, returning the same coefficients as
+ * HLowpassKaiserBessel and HBandpassKaiserBessel.
+ *
+ * The cache holds the most recently used KAISERBESSEL_CACHE_SIZE designs.
+ * Designs are returned as a copy taken while the cache is locked, since
+ * another thread may evict the cached design at any time. When persisted, new designs requested with 'persist' set are
+ * appended to ~/.booma/filters and read back by the next run. Designs that
+ * change with the frequency or filter width should not be persisted.
+ */
+class BoomaKaiserBesselDesigner {
+
+    private:
+
+        // Type ('L' or 'B'), low and high cutoff, rate, taps and attenuation
+        typedef std::tuple<char, float, float, int, int, int> Key;
+
+        // Coefficients and position in the use order
+        struct Entry {
+            std::vector<float> coefficients;
+            std::list<Key>::iterator used;
+        };
+
+        static std::map<Key, Entry> _cache;
+        static std::list<Key> _used;
+        static std::set<Key> _stored;
+        static std::mutex _mutex;
+        static std::string _filename;
+
+        static std::vector<float> Get(Key key, bool persist);
+        static void Insert(Key key, const std::vector<float>& coefficients);
+        static void Store(Key key, const std::vector<float>& coefficients);
+        static void Write(std::ostream& file, Key key, const std::vector<float>& coefficients);
+        static void Load();
+
+    public:
+
+        static std::vector<float> Lowpass(float cutoff, int rate, int taps, int attenuation, bool persist = true);
+        static std::vector<float> Bandpass(float low, float high, int rate, int taps, int attenuation, bool persist = true);
+
+        // Read stored designs and store new designs in ~/.booma
+        static void SetPersistent(bool persistent);
+};
+
+#endif
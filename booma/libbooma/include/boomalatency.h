@@ -0,0 +1,155 @@
+#ifndef __LATENCY_H
+#define __LATENCY_H
+
+#include <mutex>
+#include <vector>
+
+#include <hardtapi.h>
+
+/** Latency from capture to a named point in the chain, over the most recent blocks */
+struct LatencyStatistics {
+    std::string Name;
+    unsigned long Count;
+    double Min; // milliseconds
+    double Avg; // milliseconds
+    double P99; // milliseconds
+    double Max; // milliseconds
+};
+
+class BoomaLatency;
+
+/** Reader inserted right after the input device, stamps each block with its capture time */
+class BoomaCaptureReader : public HReader<int16_t> {
+
+    private:
+
+        HReader<int16_t>* _reader;
+        BoomaLatency* _latency;
+        double _valuesPerSecond;
+
+    public:
+
+        BoomaCaptureReader(std::string id, HReader<int16_t>* reader, BoomaLatency* latency, double valuesPerSecond);
+
+        int Read(int16_t* dest, size_t blocksize);
+
+        bool Start() {
+            return _reader->Start();
+        }
+
+        bool Stop() {
+            return _reader->Stop();
+        }
+
+        bool Command(HCommand* command) {
+            return _reader->Command(command);
+        }
+};
+
+/**
+ * Writer inserted at a named point in the chain. Finds the capture time of
+ * the first sample in each block and records the time it took to get here
+ */
+class BoomaLatencyProbe : public HWriter<int16_t>, public HWriterConsumer<int16_t> {
+
+    private:
+
+        std::string _name;
+        HWriter<int16_t>* _writer;
+        BoomaLatency* _latency;
+        double _valuesPerSecond;
+        unsigned long long _values;
+
+        // Most recent latencies in microseconds
+        std::mutex _mutex;
+        std::vector<long long> _latencies;
+        unsigned long _count;
+
+        // Stream position (seconds) to restart at with the next block
+        bool _isReset;
+        double _resetPosition;
+
+    public:
+
+        BoomaLatencyProbe(std::string name, HWriterConsumer<int16_t>* consumer, BoomaLatency* latency, double valuesPerSecond);
+
+        int Write(int16_t* src, size_t blocksize);
+
+        void SetWriter(HWriter<int16_t>* writer) {
+            _writer = writer;
+        }
+
+        bool Start() {
+            return _writer != nullptr ? _writer->Start() : true;
+        }
+
+        bool Stop() {
+            return _writer != nullptr ? _writer->Stop() : true;
+        }
+
+        bool Command(HCommand* command) {
+            return _writer != nullptr ? _writer->Command(command) : true;
+        }
+
+        LatencyStatistics GetStatistics();
+
+        void Reset(double position);
+};
+
+/**
+ * Opt-in measurement of the latency from the input device to named points
+ * in the chain. When disabled, Capture() and Probe() return the reader or
+ * writerconsumer untouched so that there is no overhead at all.
+ *
+ * Blocks can not carry a timestamp through the Hardt stages, so instead the
+ * capture time is kept per position in the input stream. Each probe counts
+ * the samples passing it and, knowing the samplerate at its point in the
+ * chain, looks up when its current sample was captured. Blocks dropped by
+ * the input thread make the following measurements too high. Stages that make
+ * the stream jump, such as the time shift buffer, must call Reset().
+ */
+class BoomaLatency {
+
+    private:
+
+        struct CaptureTime {
+            double End; // stream position (seconds) after the block
+            long long Time; // microseconds
+        };
+
+        bool _enabled;
+        std::vector<BoomaLatencyProbe*> _probes;
+        BoomaCaptureReader* _reader;
+
+        // Capture times for the most recent input blocks
+        std::mutex _mutex;
+        std::vector<CaptureTime> _captures;
+        unsigned long _captured;
+        double _position;
+
+    public:
+
+        BoomaLatency(bool enabled);
+        ~BoomaLatency();
+
+        static long long Now();
+
+        // Stamp blocks read from the input device
+        HReader<int16_t>* Capture(HReader<int16_t>* reader, double valuesPerSecond);
+
+        // Measure the latency at the stage that will be created with the returned writerconsumer
+        HWriterConsumer<int16_t>* Probe(std::string name, HWriterConsumer<int16_t>* consumer, double valuesPerSecond);
+
+        // Called by the capture reader
+        void Captured(double seconds);
+
+        // Capture time of the sample at 'position' seconds into the stream
+        bool GetCaptureTime(double position, long long* time);
+
+        // The stream continues at 'position' seconds, restart all probes from there
+        void Reset(double position);
+
+        std::vector<LatencyStatistics> GetStatistics();
+};
+
+#endif
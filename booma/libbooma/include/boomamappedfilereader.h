@@ -0,0 +1,77 @@
+#ifndef __MAPPEDFILEREADER_H
+#define __MAPPEDFILEREADER_H
+
+#include <atomic>
+#include <chrono>
+
+#include <hardtapi.h>
+
+/**
+ * Reader for pcm and wav files, a drop-in for HFileReader and HWavReader,
+ * that maps the file into memory so that it can seek to any position.
+ *
+ * Playback runs at 'speed' times real time (a speed of 0 is as fast as the
+ * chain can take the samples) and can loop at the end of the file. The
+ * position, speed and looping can be changed from any thread while the
+ * reader is running.
+ */
+class BoomaMappedFileReader : public HReader<int16_t> {
+
+    private:
+
+        int _fd;
+        char* _map;
+        size_t _mapSize;
+
+        // Samples (int16 values) in the file, excluding any header
+        int16_t* _data;
+        size_t _length;
+
+        int _rate;
+        int _channels;
+
+        std::atomic<size_t> _position;
+        std::atomic<bool> _seeked;
+        std::atomic<float> _speed;
+        std::atomic<bool> _loop;
+
+        // Playback clock, paced by the number of samples read since the clock was
+        // restarted (on seek and speed change) so that wrapping while looping is seamless
+        std::chrono::steady_clock::time_point _start;
+        size_t _played;
+        size_t _startPlayed;
+        float _startSpeed;
+
+        void ParseWav(std::string filename);
+        void Throttle();
+
+    public:
+
+        BoomaMappedFileReader(std::string id, std::string filename, bool isWav, int rate, int channels, float speed, bool loop);
+        ~BoomaMappedFileReader();
+
+        int Read(int16_t* dest, size_t blocksize);
+
+        bool Command(HCommand* command) {
+            return true;
+        }
+
+        // Position and length in seconds
+        bool Seek(double seconds);
+        double GetPosition();
+        double GetLength();
+
+        void SetSpeed(float speed);
+        float GetSpeed() {
+            return _speed;
+        }
+
+        void SetLoop(bool loop) {
+            _loop = loop;
+        }
+        bool GetLoop() {
+            return _loop;
+        }
+};
+
+#endif
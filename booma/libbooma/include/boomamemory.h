@@ -0,0 +1,67 @@
+#ifndef __MEMORY_H
+#define __MEMORY_H
+
+#include <map>
+#include <mutex>
+#include <vector>
+
+/**
+ * Working buffers for the stages in the processing chain.
+ *
+ * All buffers are cache-line aligned. When a pool has been reserved with
+ * Reserve(), buffers are carved from one region that is prefaulted and
+ * optionally backed by huge pages and locked in memory, so that the audio
+ * path never page faults. Otherwise buffers come from the heap.
+ *
+ * Freed buffers are kept, per size, and handed out again. Rebuilding the
+ * chain with the same settings therefore reuses the same buffers and does
+ * not touch the pool region or the heap allocator at all.
+ */
+class BoomaMemory {
+
+    private:
+
+        static std::mutex _mutex;
+
+        static char* _pool;
+        static size_t _poolSize;
+        static size_t _poolUsed;
+        static bool _isLocked;
+        static bool _isExhausted;
+
+        static std::map<size_t, std::vector<char*>> _free;
+        static size_t _inUse;
+        static size_t _peak;
+
+    public:
+
+        static const size_t Alignment = 64;
+
+        // Reserve a pool of 'bytes'. Fails if a pool is already reserved
+        static bool Reserve(size_t bytes, bool hugePages, bool lock);
+
+        static void* Allocate(size_t bytes);
+        static void Free(void* buffer);
+
+        // Bytes handed out right now, and the most ever handed out at once
+        static size_t GetInUse();
+        static size_t GetPeak();
+
+        static size_t GetPoolSize() {
+            return _poolSize;
+        }
+};
+
+/** Allocate a cache-line aligned working buffer of 'count' elements */
+template <class T>
+T* BoomaAllocate(size_t count) {
+    return (T*) BoomaMemory::Allocate(sizeof(T) * count);
+}
+
+/** Return a buffer allocated with BoomaAllocate() */
+template <class T>
+void BoomaFree(T* buffer) {
+    BoomaMemory::Free((void*) buffer);
+}
+
+#endif
@@ -0,0 +1,88 @@
+#ifndef __MIXER_H
+#define __MIXER_H
+
+#include <hardtapi.h>
+
+#include "boomanco.h"
+
+/**
+ * Mixers and tone generator driven by a BoomaNco, drop-ins for HMultiplier,
+ * HIqMultiplier and HSineGenerator with unity gain oscillators.
+ *
+ * Retunes with SetFrequency() are phase continuous.
+ */
+
+/** Multiplies real samples with cos(2 pi f t) */
+class BoomaMixer : public HFilter<int16_t> {
+
+    private:
+
+        BoomaNco* _nco;
+        float* _cos;
+
+        void Init(int rate, float frequency, size_t blocksize);
+
+    public:
+
+        BoomaMixer(std::string id, HWriterConsumer<int16_t>* consumer, int rate, float frequency, size_t blocksize);
+        BoomaMixer(std::string id, HWriter<int16_t>* writer, int rate, float frequency, size_t blocksize);
+        ~BoomaMixer();
+
+        void Filter(int16_t* src, int16_t* dest, size_t blocksize);
+
+        void SetFrequency(float frequency) {
+            _nco->SetFrequency(frequency);
+        }
+};
+
+/** Multiplies interleaved IQ samples with exp(j 2 pi f t), moving the spectrum up by f */
+class BoomaIqMixer : public HFilter<int16_t> {
+
+    private:
+
+        BoomaNco* _nco;
+        float* _cos;
+        float* _sin;
+
+        void Init(int rate, float frequency, size_t blocksize);
+
+    public:
+
+        BoomaIqMixer(std::string id, HWriterConsumer<int16_t>* consumer, int rate, float frequency, size_t blocksize);
+        BoomaIqMixer(std::string id, HWriter<int16_t>* writer, int rate, float frequency, size_t blocksize);
+        ~BoomaIqMixer();
+
+        void Filter(int16_t* src, int16_t* dest, size_t blocksize);
+
+        void SetFrequency(float frequency) {
+            _nco->SetFrequency(frequency);
+        }
+};
+
+/** Sine tone source */
+class BoomaToneGenerator : public HReader<int16_t> {
+
+    private:
+
+        BoomaNco* _nco;
+        float* _cos;
+        size_t _blocksize;
+        float _amplitude;
+
+    public:
+
+        BoomaToneGenerator(std::string id, int rate, float frequency, int amplitude, size_t blocksize);
+        ~BoomaToneGenerator();
+
+        int Read(int16_t* dest, size_t blocksize);
+
+        bool Command(HCommand* command) {
+            return true;
+        }
+
+        void SetFrequency(float frequency) {
+            _nco->SetFrequency(frequency);
+        }
+};
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef __NCO_H
+#define __NCO_H
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+
+#include "booma.h"
+
+/**
+ * Numerically controlled oscillator, replacing per-sample trigonometry in
+ * the mixers and tone generators.
+ *
+ * A 32 bit phase accumulator indexes a sine table with 2^bits entries, where
+ * bits is chosen for the requested spurious free dynamic range (about 6 dB
+ * per bit). Tables are shared between all oscillators of the same size.
+ * Changing the frequency only changes the phase increment, so the output
+ * stays phase continuous across retunes.
+ */
+class BoomaNco {
+
+    private:
+
+        static std::map<int, std::vector<float>> _tables;
+        static std::mutex _mutex;
+
+        float* _table;
+        int _bits;
+        int _rate;
+        float _frequency;
+
+        uint32_t _phase;
+        uint32_t _increment;
+
+    public:
+
+        BoomaNco(int rate, float frequency, float sfdr = NCO_SFDR);
+
+        void SetFrequency(float frequency);
+        float GetFrequency() {
+            return _frequency;
+        }
+
+        // Next 'count' oscillator values, 'sin' may be nullptr
+        void Generate(float* cos, float* sin, size_t count);
+
+        static int GetTableBits(float sfdr);
+};
+
+#endif
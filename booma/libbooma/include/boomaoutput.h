@@ -4,6 +4,16 @@
 #include <hardtapi.h>
 #include "configoptions.h"
 #include "boomareceiver.h"
+#include "boomamixer.h"
+#include "boomaprofiler.h"
+#include "boomalatency.h"
+#include "boomafirfilter.h"
+#include "boomaspectrum.h"
+#include "boomademandgate.h"
+#include "boomasplitter.h"
+#include "boomadelay.h"
+#include "boomadumpwriter.h"
+#include "boomatrigger.h"
 
 class BoomaOutput {
 
@@ -16,14 +26,15 @@ class BoomaOutput {
         HFileWriter<int16_t>* _pcmWriter;
         HWavWriter<int16_t>* _wavWriter;
         HGain<int16_t>* _outputVolume;
-        HFirFilter<int16_t>* _outputFilter;
+        BoomaFirFilter* _outputFilter;
 
         // Splitting audio and RF
         HWriter<int16_t>* _audioWriter;
-        HSplitter<int16_t>* _audioSplitter;
+        BoomaSplitter* _audioSplitter;
         HBreaker<int16_t>* _audioBreaker;
         HBufferedWriter<int16_t>* _audioBuffer;
-        HDelay<int16_t>* _audioDelay;
+        BoomaDelay* _audioDelay;
+        BoomaTrigger* _trigger;
 
         // Signal level reporting
         HSplitter<int16_t>* _ifSplitter;
@@ -33,19 +44,15 @@ class BoomaOutput {
         int _signalStrength;
         int _signalMax;
         double _signalSum;
+        size_t _blocksize;
 
         // Audio spectrum reporting
-        HFftOutput<int16_t>* _audioFft;
-        HCustomWriter<HFftResults>* _audioFftWriter;
-        int AudioFftCallback(HFftResults* result, size_t length);
-        HHammingWindow<int16_t>* _audioFftWindow;
-        double* _audioSpectrum;
-        int _audioFftSize;
-        int _audioSpectrumSize;
+        BoomaDemandGate* _audioFftGate;
+        BoomaSpectrum* _audioFft;
         HAgc<int16_t>* _audioFftGain;
 
         // Frequency alignment
-        HSineGenerator<int16_t>* _frequencyAlignmentGenerator;
+        BoomaToneGenerator* _frequencyAlignmentGenerator;
         HLinearMixer<int16_t>* _frequencyAlignmentMixer;
         HWriterConsumer<int16_t>* GetOutputVolumeConsumer() {
             return _frequencyAlignmentMixer == nullptr
@@ -56,14 +63,23 @@ class BoomaOutput {
         // Output filter
         int _outputFilterWidth;
 
+        // Stage profiling
+        BoomaProfiler* _profiler;
+
         bool IsWav(std::string filename);
 
     public:
 
-        BoomaOutput(ConfigOptions* opts, BoomaReceiver* receiver);
+        BoomaOutput(ConfigOptions* opts, BoomaReceiver* receiver, BoomaLatency* latency = nullptr);
         ~BoomaOutput();
 
         bool SetDumpAudio(bool enabled);
+
+        // Signal level trigger for dumps, nullptr if dumps are not triggered
+        BoomaTrigger* GetTrigger() {
+            return _trigger;
+        }
+        unsigned long GetDroppedDumpBlocks();
         int SetVolume(int volume);
 
         int GetSignalLevel();
@@ -75,7 +91,12 @@ class BoomaOutput {
         }
 
         int GetAudioFftSize();
-        int GetAudioSpectrum(double* spectrum);
+        int GetAudioSpectrum(double* spectrum, int size, unsigned long* sequence = nullptr);
+        bool SetAudioSpectrum(int size, int overlap, int averaging);
+
+        std::vector<StageStatistics> GetStageStatistics() {
+            return _profiler->GetStatistics();
+        }
 };
 
 #endif
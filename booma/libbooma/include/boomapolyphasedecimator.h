@@ -0,0 +1,55 @@
+#ifndef __POLYPHASEDECIMATOR_H
+#define __POLYPHASEDECIMATOR_H
+
+#include <hardtapi.h>
+
+/**
+ * Polyphase FIR decimator for real or IQ (interleaved) samples.
+ *
+ * Only the samples that are kept after decimation are calculated. Each kept
+ * output is a single dot product of the (reversed) filter over the input
+ * window ending at that sample, which is the sum of the outputs of the
+ * 'factor' polyphase branches. The decimation factor can be any integer,
+ * it does not need to divide the blocksize.
+ */
+class BoomaPolyphaseDecimator : public HReader<int16_t> {
+
+    private:
+
+        HReader<int16_t>* _reader;
+        int _factor;
+        int _taps;
+        size_t _blocksize;
+        int _channels;
+
+        // Reversed coefficients, so that each output is a straight dot product
+        float* _coefficients;
+
+        // Input blocks and per-channel sample windows (history + new samples)
+        int16_t* _input;
+        float** _windows;
+        int _windowLength;
+
+        static float Dot(float* coefficients, float* samples, int taps);
+
+    public:
+
+        BoomaPolyphaseDecimator(std::string id, HReader<int16_t>* reader, int factor, float* coefficients, int taps, size_t blocksize, bool isIq);
+        ~BoomaPolyphaseDecimator();
+
+        int Read(int16_t* dest, size_t blocksize);
+
+        bool Start() {
+            return _reader->Start();
+        }
+
+        bool Stop() {
+            return _reader->Stop();
+        }
+
+        bool Command(HCommand* command) {
+            return _reader->Command(command);
+        }
+};
+
+#endif
@@ -0,0 +1,142 @@
+#ifndef __PROFILER_H
+#define __PROFILER_H
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#include <hardtapi.h>
+
+/** Timing statistics for a single named stage in the processing chain */
+struct StageStatistics {
+    std::string Name;
+    unsigned long Calls;
+
+    // Time spend in the stage itself, excluding time spend in
+    // profiled stages further down (or up, for readers) the chain
+    double Total; // microseconds
+    double Max; // microseconds
+};
+
+/** Common timekeeping for writer and reader stage timers */
+class BoomaStageTime {
+
+    private:
+
+        // The timer currently measuring on this thread (if any)
+        static thread_local BoomaStageTime* _active;
+
+        std::string _name;
+        std::atomic<unsigned long> _calls;
+        std::atomic<unsigned long long> _total;
+        std::atomic<unsigned long long> _max;
+
+        BoomaStageTime* _parent;
+        std::chrono::steady_clock::time_point _start;
+        unsigned long long _nested;
+
+    protected:
+
+        BoomaStageTime(std::string name);
+
+        void Begin();
+        void End();
+
+    public:
+
+        virtual ~BoomaStageTime() {}
+
+        StageStatistics GetStatistics();
+};
+
+/**
+ * Writer inserted in front of a stage that is pushed to. Times the call
+ * to the stage's Write() method
+ */
+class BoomaStageWriterTimer : public HWriter<int16_t>, public HWriterConsumer<int16_t>, public BoomaStageTime {
+
+    private:
+
+        HWriter<int16_t>* _writer;
+
+    public:
+
+        BoomaStageWriterTimer(std::string name, HWriterConsumer<int16_t>* consumer);
+
+        int Write(int16_t* src, size_t blocksize);
+
+        void SetWriter(HWriter<int16_t>* writer) {
+            _writer = writer;
+        }
+
+        bool Start() {
+            return _writer != nullptr ? _writer->Start() : true;
+        }
+
+        bool Stop() {
+            return _writer != nullptr ? _writer->Stop() : true;
+        }
+
+        bool Command(HCommand* command) {
+            return _writer != nullptr ? _writer->Command(command) : true;
+        }
+};
+
+/**
+ * Reader inserted after a stage that is pulled from. Times the call
+ * to the stage's Read() method
+ */
+class BoomaStageReaderTimer : public HReader<int16_t>, public BoomaStageTime {
+
+    private:
+
+        HReader<int16_t>* _reader;
+
+    public:
+
+        BoomaStageReaderTimer(std::string name, HReader<int16_t>* reader);
+
+        int Read(int16_t* dest, size_t blocksize);
+
+        bool Start() {
+            return _reader->Start();
+        }
+
+        bool Stop() {
+            return _reader->Stop();
+        }
+
+        bool Command(HCommand* command) {
+            return _reader->Command(command);
+        }
+};
+
+/**
+ * Opt-in profiling of the named stages in a chain. When disabled, the
+ * Wrap() functions return the writerconsumer or reader untouched so that
+ * there is no overhead at all.
+ */
+class BoomaProfiler {
+
+    private:
+
+        bool _enabled;
+        std::vector<BoomaStageTime*> _timers;
+
+    public:
+
+        BoomaProfiler(bool enabled):
+            _enabled(enabled) {}
+
+        ~BoomaProfiler();
+
+        // Profile the stage that will be created with the returned writerconsumer
+        HWriterConsumer<int16_t>* Wrap(std::string name, HWriterConsumer<int16_t>* consumer);
+
+        // Profile the given reader stage, read from the returned reader
+        HReader<int16_t>* Wrap(std::string name, HReader<int16_t>* reader);
+
+        std::vector<StageStatistics> GetStatistics();
+};
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef __RATIONALRESAMPLER_H
+#define __RATIONALRESAMPLER_H
+
+#include <hardtapi.h>
+
+/**
+ * Rational L/M polyphase resampler for real or IQ (interleaved) samples.
+ *
+ * The prototype lowpass filter is designed at 'L' times the input rate and
+ * split into 'L' phases of 'taps / L' coefficients, each output sample is a
+ * single dot product with one of the phases. Input blocks are read as needed,
+ * every read returns exactly one block of output samples.
+ */
+class BoomaRationalResampler : public HReader<int16_t> {
+
+    private:
+
+        HReader<int16_t>* _reader;
+        int _interpolation;
+        int _decimation;
+        int _tapsPerPhase;
+        size_t _blocksize;
+        int _channels;
+
+        // Reversed and gain corrected coefficients, one row per phase
+        float** _phases;
+
+        // Upstream block and per-channel sample buffers with 'tapsPerPhase - 1' samples history
+        int16_t* _input;
+        float** _buffers;
+        int _length;
+        int _index;
+        int _phase;
+
+        bool Fill();
+
+    public:
+
+        BoomaRationalResampler(std::string id, HReader<int16_t>* reader, int interpolation, int decimation, float* coefficients, int taps, size_t blocksize, bool isIq);
+        ~BoomaRationalResampler();
+
+        int Read(int16_t* dest, size_t blocksize);
+
+        bool Start() {
+            return _reader->Start();
+        }
+
+        bool Stop() {
+            return _reader->Stop();
+        }
+
+        bool Command(HCommand* command) {
+            return _reader->Command(command);
+        }
+
+        // Number of prototype filter taps needed for the given rates and passband
+        static int GetTaps(int interpolation, int inputRate, int outputRate, int cutoff, float attenuation);
+};
+
+#endif
@@ -6,6 +6,8 @@
 #include "boomainput.h"
 #include "boomadecoder.h"
 #include "option.h"
+#include "boomaprofiler.h"
+#include "boomasplitter.h"
 
 #include "boomareceiverexception.h"
 
@@ -21,7 +23,7 @@ class BoomaReceiver {
         HWriterConsumer<int16_t>* _preProcess;
         HWriterConsumer<int16_t>* _receive;
         HWriterConsumer<int16_t>* _postProcess;
-        HSplitter<int16_t>* _decoder;
+        BoomaSplitter* _decoder;
 
         std::vector<Option> _options;
 
@@ -29,6 +31,9 @@ class BoomaReceiver {
 
         bool _hasBuilded;
 
+        // Stage profiling
+        BoomaProfiler* _profiler;
+
         bool SetOption(ConfigOptions* opts, std::string name, int value);
 
     protected:
@@ -59,17 +64,24 @@ class BoomaReceiver {
         BoomaReceiver(ConfigOptions* opts, int initialFrequency):
             _hasBuilded(false),
             _frequency(initialFrequency),
-            _rfAgc(nullptr) {
+            _rfAgc(nullptr),
+            _profiler(nullptr) {
 
             HLog("Creating BoomaReceiver with initial frequency %d", _frequency);
         }
 
         int GetRfAgcLevel(ConfigOptions* opts);
 
+        // Profile the stage that will be created with the returned writerconsumer
+        HWriterConsumer<int16_t>* Profile(std::string name, HWriterConsumer<int16_t>* previous) {
+            return _profiler->Wrap(name, previous);
+        }
+
     public:
 
         virtual ~BoomaReceiver() {
             SAFE_DELETE(_rfAgc);
+            SAFE_DELETE(_profiler);
         }
 
         virtual int GetOutputFilterWidth() {
@@ -87,6 +99,7 @@ class BoomaReceiver {
         virtual std::string GetOptionInfoString() = 0;
 
         void Build(ConfigOptions* opts, BoomaInput* input, BoomaDecoder* decoder = NULL);
+        void Build(ConfigOptions* opts, HWriterConsumer<int16_t>* source, BoomaDecoder* decoder = NULL);
 
         bool SetFrequency(ConfigOptions* opts, int frequency) {
             _frequency = frequency;
@@ -115,6 +128,10 @@ class BoomaReceiver {
         }
 
         bool SetRfGainEnabled(bool enabled);
+
+        std::vector<StageStatistics> GetStageStatistics() {
+            return _profiler != nullptr ? _profiler->GetStatistics() : std::vector<StageStatistics>();
+        }
 };
 
 #endif
@@ -0,0 +1,112 @@
+#ifndef __SIGMF_H
+#define __SIGMF_H
+
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <hardtapi.h>
+
+#include "configoptions.h"
+#include "boomadumpwriter.h"
+
+/**
+ * RF recorder writing a SigMF recording: the raw samples in 'name.sigmf-data'
+ * (ci16_le for IQ, ri16_le for real input) and a 'name.sigmf-meta' sidecar.
+ *
+ * The sidecar has a capture segment for each retune, an annotation for each
+ * gain change and a 'booma:index' with the wall clock time and byte offset
+ * once every second of samples. Captures hold the center frequency of the
+ * samples (the hardware frequency) in 'core:frequency' and the frequency
+ * booma was tuned to in 'booma:frequency'. 'booma:source' is the original
+ * input source type, so that a replay takes the same path through the input. Since the data is raw samples at a fixed
+ * rate, any sample can be found by offset without reading the file.
+ *
+ * With 'blocks' above 0, the samples are written by a BoomaDumpWriter with a
+ * ring of that many blocks, so the dsp thread never waits for the disk.
+ * Blocks dropped by a full ring are left out of the recording and the
+ * sample count, the index shows the gap in wall clock time.
+ *
+ * 'delay' is the number of frames still on their way to the recorder when an
+ * event happens (the rf delay line), events are placed that many frames
+ * after the last written frame.
+ */
+class BoomaSigMFWriter : public HWriter<int16_t> {
+
+    private:
+
+        struct Event {
+            unsigned long Sample;
+            std::string Datetime;
+            long Frequency;
+            long Tuned;
+            int Gain;
+        };
+
+        std::string _filename;
+        std::ofstream _data;
+        BoomaDumpWriter* _dump;
+        std::mutex _mutex;
+        bool _recording;
+
+        int _rate;
+        int _channels;
+        InputSourceType _source;
+        unsigned long _delay;
+
+        // Frames written
+        unsigned long _written;
+
+        std::vector<Event> _captures;
+        std::vector<Event> _annotations;
+        std::vector<Event> _index;
+        long _frequency;
+        long _tuned;
+        int _gain;
+
+        static std::string Now(double offset = 0);
+        void WriteMetadata();
+
+    public:
+
+        BoomaSigMFWriter(std::string id, std::string filename, HWriterConsumer<int16_t>* consumer, int rate, bool isIq, InputSourceType source, long frequency, long tuned, int gain, unsigned long delay, size_t blocksize, int blocks);
+        ~BoomaSigMFWriter();
+
+        int Write(int16_t* src, size_t blocksize);
+
+        bool Stop();
+
+        bool Command(HCommand* command) {
+            return true;
+        }
+
+        // Events, recorded at the position the current live samples will get in the recording
+        void Retune(long frequency, long tuned);
+        void SetGain(int gain);
+
+        unsigned long GetDroppedBlocks() {
+            return _dump != nullptr ? _dump->GetDroppedBlocks() : 0;
+        }
+};
+
+/**
+ * Metadata read back from a SigMF sidecar written by BoomaSigMFWriter, used to
+ * restore the tuning when a recording is replayed
+ */
+class BoomaSigMFMetadata {
+
+    public:
+
+        int SampleRate = 0;
+        bool IsIq = false;
+        InputSourceType Source = NO_INPUT_SOURCE_TYPE;
+        // Tuned frequency of the first capture, the center frequency if it was not recorded by booma
+        long Frequency = 0;
+        std::string DataFile;
+
+        // Returns false if 'filename' (.sigmf-meta or .sigmf-data) has no readable sidecar
+        bool Read(std::string filename);
+};
+
+#endif
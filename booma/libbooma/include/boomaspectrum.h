@@ -0,0 +1,105 @@
+#ifndef __SPECTRUM_H
+#define __SPECTRUM_H
+
+#include <atomic>
+#include <mutex>
+
+#include <hardtapi.h>
+
+#include "booma.h"
+#include "boomafft.h"
+#include "boomaspectrumbuffer.h"
+
+/** Window applied to each fft frame */
+enum BoomaSpectrumWindow {
+    RECTANGULAR_WINDOW = 0,
+    HAMMING_WINDOW = 1
+};
+
+/**
+ * Spectrum calculation with fft size, overlap and averaging that can be
+ * changed at runtime.
+ *
+ * An fft of 'size' is a 'size' point fft for realvalued samples or a
+ * 'size / 2' point fft for IQ samples. Either way the spectrum has
+ * 'size / 2' bins. Consecutive ffts overlap by 'overlap' percent and
+ * 'averaging' fft magnitudes are averaged for each published spectrum.
+ *
+ * With a zoom factor above 1 (realvalued samples only), the samples are
+ * lowpass filtered and decimated so that the spectrum covers the lowest
+ * 1/zoom part of the input spectrum.
+ *
+ * New settings are picked up by the dsp thread at the start of the next
+ * block, so the chain does not have to be rebuilt.
+ */
+class BoomaSpectrum : public HWriter<int16_t> {
+
+    private:
+
+        bool _isIq;
+        BoomaSpectrumWindow _windowType;
+        int _zoom;
+
+        // Active settings, only used by the dsp thread
+        int _size;
+        int _points;
+        int _hop;
+        int _averaging;
+        BoomaFft* _fft;
+        float* _window;
+        float* _re;
+        float* _im;
+        double* _sum;
+        int _averaged;
+
+        // Collected samples (interleaved for IQ) waiting for the next fft
+        float* _samples;
+        int _count;
+
+        // Zoom lowpass filter and the history it runs over
+        float* _zoomCoefficients;
+        int _zoomTaps;
+        float* _zoomHistory;
+        int _zoomPhase;
+
+        // Requested settings
+        std::mutex _mutex;
+        std::atomic<bool> _pending;
+        int _requestedSize;
+        int _requestedOverlap;
+        int _requestedAveraging;
+
+        BoomaSpectrumBuffer* _buffer;
+
+        void Apply();
+        void Release();
+        void Add(float* samples, int count);
+        void Calculate();
+
+    public:
+
+        BoomaSpectrum(std::string id, HWriterConsumer<int16_t>* consumer, int rate, bool isIq, BoomaSpectrumWindow window, int zoom, int size, int overlap, int averaging);
+        ~BoomaSpectrum();
+
+        int Write(int16_t* src, size_t blocksize);
+
+        bool Command(HCommand* command) {
+            return true;
+        }
+
+        // Request new settings. Applied from the next block
+        bool Configure(int size, int overlap, int averaging);
+
+        static bool IsValid(int size, int overlap, int averaging);
+
+        int GetSize();
+        int GetOverlap();
+        int GetAveraging();
+
+        // Copy the newest spectrum, see BoomaSpectrumBuffer::Read()
+        int GetSpectrum(double* spectrum, int size, unsigned long* sequence = nullptr) {
+            return _buffer->Read(spectrum, size, sequence);
+        }
+};
+
+#endif
@@ -0,0 +1,61 @@
+#ifndef __SPECTRUMBUFFER_H
+#define __SPECTRUMBUFFER_H
+
+#include <atomic>
+#include <chrono>
+
+/**
+ * Lock-free exchange of spectrum frames from the dsp thread to any number
+ * of reader (gui) threads.
+ *
+ * Frames are written round robin into three slots, so the slot being written
+ * is never the newest or the previous frame. Each slot carries a version that
+ * is odd while the slot is being written, a reader copies the newest frame and
+ * retries if the version changed during the copy. Readers never block the
+ * writer and never see a partially written frame.
+ *
+ * Each frame has a sequence number (the first frame is 1) and the time it
+ * was published, so readers can tell if there is a new frame at all. Frames
+ * can have any size up to the capacity of the buffer.
+ */
+class BoomaSpectrumBuffer {
+
+    private:
+
+        struct Slot {
+            std::atomic<unsigned long> Version;
+            unsigned long Sequence;
+            int Size;
+            std::chrono::steady_clock::time_point Timestamp;
+            double* Spectrum;
+        };
+
+        int _capacity;
+        Slot _slots[3];
+        std::atomic<unsigned long> _sequence;
+        std::atomic<int> _size;
+
+    public:
+
+        BoomaSpectrumBuffer(int capacity, int size);
+        ~BoomaSpectrumBuffer();
+
+        // Writer: publish a new frame of 'size' values
+        void Publish(double* spectrum, int size);
+
+        // Reader: copy the newest frame, at most 'size' values. If 'sequence' is given and no
+        // frame newer than '*sequence' has been published, nothing is copied and 0 is returned.
+        // Otherwise '*sequence' is set to the sequence number of the copied frame
+        int Read(double* spectrum, int size, unsigned long* sequence = nullptr, std::chrono::steady_clock::time_point* timestamp = nullptr);
+
+        unsigned long GetSequence() {
+            return _sequence.load(std::memory_order_acquire);
+        }
+
+        // Size of the newest frame
+        int GetSize() {
+            return _size.load(std::memory_order_acquire);
+        }
+};
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef __SPLITTER_H
+#define __SPLITTER_H
+
+#include <vector>
+
+#include <hardtapi.h>
+
+#include "boomablockpool.h"
+
+/** Stage that can keep a reference to a shared block instead of copying it */
+class BoomaBlockWriter {
+
+    public:
+
+        virtual ~BoomaBlockWriter() {}
+
+        // The block is read only. Take a reference to keep it after returning
+        virtual int WriteBlock(BoomaBlock<int16_t>* block) = 0;
+};
+
+/**
+ * Splitter, a drop-in for HSplitter, that writes each block to all branches
+ * without copying it.
+ *
+ * Plain branches (SetWriter) all get the incoming block and must not modify
+ * it. Branches that modify their input in place are added with 'inPlace'
+ * set and get a private copy. Branches that keep blocks after returning
+ * (SetBlockWriter) share one pooled, reference counted copy of the block,
+ * so no matter how many of them there are, the block is copied once.
+ *
+ * Branches are written in the order they were added.
+ */
+class BoomaSplitter : public HWriter<int16_t>, public HWriterConsumer<int16_t> {
+
+    private:
+
+        enum BranchType {
+            SHARED,
+            IN_PLACE,
+            BLOCK
+        };
+
+        struct Branch {
+            BranchType Type;
+            HWriter<int16_t>* Writer;
+            BoomaBlockWriter* BlockWriter;
+        };
+
+        std::vector<Branch> _branches;
+        BoomaBlockPool<int16_t>* _pool;
+
+    public:
+
+        BoomaSplitter(std::string id, HWriterConsumer<int16_t>* consumer, size_t blocksize);
+
+        int Write(int16_t* src, size_t blocksize);
+
+        void SetWriter(HWriter<int16_t>* writer) {
+            SetWriter(writer, false);
+        }
+
+        void SetWriter(HWriter<int16_t>* writer, bool inPlace);
+
+        void SetBlockWriter(BoomaBlockWriter* writer);
+
+        bool Start();
+        bool Stop();
+        bool Command(HCommand* command);
+};
+
+#endif
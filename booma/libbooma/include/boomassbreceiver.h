@@ -6,6 +6,7 @@
 #include "booma.h"
 #include "configoptions.h"
 #include "boomareceiver.h"
+#include "boomamixer.h"
 
 class BoomaSsbReceiver : public BoomaReceiver {
 
@@ -13,9 +14,9 @@ class BoomaSsbReceiver : public BoomaReceiver {
 
         // Preprocessing
         HIqFirFilter<int16_t>* _inputFirFilter;
-        HIqMultiplier<int16_t>* _iqMultiplier;
+        BoomaIqMixer* _iqMultiplier;
         HIqFirFilter<int16_t>* _iqFirFilter;
-        HIqMultiplier<int16_t>* _basebandMultiplier;
+        BoomaIqMixer* _basebandMultiplier;
         HBiQuadFilter<HLowpassBiQuad<int16_t>, int16_t>* _lowpassFilter;
         HIqAddOrSubtractConverter<int16_t>* _iqAdder;
         HCollector<int16_t>* _collector;
@@ -0,0 +1,65 @@
+#ifndef __THREADEDREADER_H
+#define __THREADEDREADER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <hardtapi.h>
+
+#include "boomablockring.h"
+
+/**
+ * Reader that pulls from its upstream reader (typically the device reader
+ * and the decimation stages) on a separate thread and hands the blocks
+ * over to the processor thread through a lock-free block ring.
+ *
+ * The upstream reader is drained at its own pace. If the rest of the chain
+ * can not keep up and the ring is full, the newest block from a live
+ * device is dropped and counted - the device must never be kept waiting.
+ * Input that is not live, such as files, waits for room in the ring instead.
+ *
+ * The ring itself is lock-free, the mutex and condition variable are only
+ * used to wake up a side that is waiting for a block or for room.
+ */
+class BoomaThreadedReader : public HReader<int16_t> {
+
+    private:
+
+        HReader<int16_t>* _reader;
+        bool _live;
+        BoomaBlockRing<int16_t>* _ring;
+        int16_t* _overflow;
+
+        std::thread* _thread;
+        std::atomic<bool> _running;
+        std::atomic<bool> _finished;
+        std::atomic<unsigned long> _dropped;
+
+        std::mutex _mutex;
+        std::condition_variable _changed;
+
+        void Produce();
+        void Notify();
+
+    public:
+
+        BoomaThreadedReader(std::string id, HReader<int16_t>* reader, size_t blocksize, int blocks, bool live);
+        ~BoomaThreadedReader();
+
+        int Read(int16_t* dest, size_t blocksize);
+
+        bool Start();
+        bool Stop();
+
+        bool Command(HCommand* command) {
+            return _reader->Command(command);
+        }
+
+        unsigned long GetDroppedBlocks() {
+            return _dropped;
+        }
+};
+
+#endif
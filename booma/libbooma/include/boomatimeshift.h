@@ -0,0 +1,105 @@
+#ifndef __TIMESHIFT_H
+#define __TIMESHIFT_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include <hardtapi.h>
+
+#include "boomalatency.h"
+
+/**
+ * Time shift buffer keeping the last 'seconds' of (decimated) input.
+ *
+ * The upstream reader is drained into a ring of blocks on a separate thread,
+ * at its own pace. Live input overwrites the oldest blocks, input that is not
+ * live (files, generators) waits until the chain has read the block that
+ * would be overwritten. The chain normally reads the newest block, but after a
+ * Rewind() it replays every block from the rewound position, as fast as the
+ * chain can process them but no faster than 'speed' times real time (0 for
+ * no limit), until it has caught up with live input.
+ *
+ * Whenever the stream jumps (rewind, go live, or falling so far behind that
+ * the oldest blocks are overwritten) the latency probes are restarted at the
+ * new stream position. A block that is overwritten while it is being copied
+ * is read again from the oldest safe position.
+ *
+ * The samples are kept as they are read (16 bit, IQ interleaved), that is
+ * 'rate * channels * 2 * 60' bytes per minute.
+ */
+class BoomaTimeShift : public HReader<int16_t> {
+
+    private:
+
+        HReader<int16_t>* _reader;
+        int16_t* _buffer;
+        int* _lengths;
+        size_t _blocks;
+        size_t _blocksize;
+        int _rate;
+        int _channels;
+        float _speed;
+        bool _live;
+        BoomaLatency* _latency;
+
+        // Total number of blocks written by the capture thread, the position of
+        // the chain and the last block read by the chain, all counted from the start
+        std::atomic<unsigned long> _head;
+        std::atomic<unsigned long> _position;
+        std::atomic<bool> _isShifted;
+        unsigned long _last;
+
+        std::thread* _thread;
+        std::atomic<bool> _running;
+        std::atomic<bool> _finished;
+
+        // Guards the rewind start and signals new blocks and chain progress
+        std::mutex _mutex;
+        std::condition_variable _changed;
+
+        // Measured speed during the last catch up
+        std::chrono::steady_clock::time_point _rewound;
+        unsigned long _rewoundPosition;
+        std::atomic<double> _catchUpSpeed;
+
+        void Capture();
+
+        double GetSecondsPerBlock() {
+            return (double) _blocksize / (_rate * _channels);
+        }
+
+    public:
+
+        BoomaTimeShift(std::string id, HReader<int16_t>* reader, size_t blocksize, int rate, int channels, int seconds, float speed, bool live, BoomaLatency* latency = nullptr);
+        ~BoomaTimeShift();
+
+        int Read(int16_t* dest, size_t blocksize);
+
+        bool Start();
+        bool Stop();
+
+        bool Command(HCommand* command) {
+            return _reader->Command(command);
+        }
+
+        // Replay from 'seconds' back (limited to the buffer length), or return to live input
+        bool Rewind(int seconds);
+        void GoLive();
+
+        // Seconds behind live input
+        double GetDelay();
+
+        double GetMemoryPerMinute() {
+            return (double) _rate * _channels * sizeof(int16_t) * 60;
+        }
+
+        // Measured times real time, while catching up or for the last catch up
+        double GetCatchUpSpeed() {
+            return _catchUpSpeed;
+        }
+};
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef __TRIGGER_H
+#define __TRIGGER_H
+
+#include <chrono>
+#include <map>
+#include <mutex>
+
+#include <hardtapi.h>
+
+/**
+ * Signal level trigger for dumps.
+ *
+ * The dump breakers sit behind delay lines holding the last 'preroll'
+ * seconds, so when the signal level reaches 'level' and the breakers are
+ * opened, the dump starts 'preroll' seconds before the trigger. The
+ * breakers are kept open until the level has been below 'level' for 'hold'
+ * seconds, plus the preroll so that the delayed tail also gets written.
+ *
+ * Only armed breakers are opened, a dump that is toggled on while the
+ * trigger is active is armed instead of started.
+ */
+class BoomaTrigger {
+
+    private:
+
+        int _level;
+        std::chrono::milliseconds _hold;
+
+        std::map<HBreaker<int16_t>*, bool> _breakers;
+        std::mutex _mutex;
+
+        bool _triggered;
+        std::chrono::steady_clock::time_point _lastActive;
+        unsigned long _events;
+
+        void Apply(HBreaker<int16_t>* breaker, bool armed);
+
+    public:
+
+        BoomaTrigger(int level, int hold, int preroll);
+
+        // Add a breaker to be controlled by the trigger, returns 'armed'
+        bool Arm(HBreaker<int16_t>* breaker, bool armed);
+
+        // Called with each new signal level (S units)
+        void Update(int level);
+
+        bool IsTriggered() {
+            return _triggered;
+        }
+
+        unsigned long GetEvents() {
+            return _events;
+        }
+};
+
+#endif
@@ -23,6 +23,9 @@ class ConfigOptions {
         std::string _section = "default";
         std::string _activeSection = "default";
 
+        // Transient copies are never written to the stored configuration
+        bool _isTransient = false;
+
         void PrintUsage(bool showSecretSettings = false);
         void PrintAudioDevices(bool hardwareDevices = true, bool virtualDevices = false);
         void PrintRtlsdrDevices();
@@ -43,6 +46,9 @@ class ConfigOptions {
     public:
 
         ConfigOptions(std::string appName, std::string appVersion, int argc, char** argv);
+
+        // Transient copy of the active section, for receivers that need their own settings
+        ConfigOptions(ConfigOptions* other);
         ~ConfigOptions();
 
         void SyncStoredConfig();
@@ -231,6 +237,22 @@ class ConfigOptions {
             return _values.at(_section)->_wavFile;
         }
 
+        float GetInputFileSpeed() {
+            return _values.at(_section)->_inputFileSpeed;
+        }
+
+        void SetInputFileSpeed(float speed) {
+            _values.at(_section)->_inputFileSpeed = speed;
+        }
+
+        bool GetInputFileLoop() {
+            return _values.at(_section)->_inputFileLoop;
+        }
+
+        void SetInputFileLoop(bool loop) {
+            _values.at(_section)->_inputFileLoop = loop;
+        }
+
         bool SetWavFile(std::string filename) {
             _values.at(_section)->_wavFile = filename;
             return true;
@@ -240,6 +262,18 @@ class ConfigOptions {
             return _values.at(_section)->_enableProbes;
         }
 
+        bool GetEnableBlockTiming() {
+            return _values.at(_section)->_enableBlockTiming;
+        }
+
+        bool GetEnableProfiling() {
+            return _values.at(_section)->_enableProfiling;
+        }
+
+        bool GetEnableLatency() {
+            return _values.at(_section)->_enableLatency;
+        }
+
         int GetReservedBuffers() {
             return _values.at(_section)->_reservedBuffers;
         }
@@ -314,6 +348,126 @@ class ConfigOptions {
             return _values.at(_section)->_firFilterSize;
         }
 
+        int GetInputThreadBlocks() {
+            return _values.at(_section)->_inputThreadBlocks;
+        }
+
+        int GetDumpThreadBlocks() {
+            return _values.at(_section)->_dumpThreadBlocks;
+        }
+
+        int GetDumpRotateSize() {
+            return _values.at(_section)->_dumpRotateSize;
+        }
+
+        int GetDumpRotateDuration() {
+            return _values.at(_section)->_dumpRotateDuration;
+        }
+
+        int GetDumpPreroll() {
+            return _values.at(_section)->_dumpPreroll;
+        }
+
+        int GetTriggerLevel() {
+            return _values.at(_section)->_triggerLevel;
+        }
+
+        int GetTriggerHold() {
+            return _values.at(_section)->_triggerHold;
+        }
+
+        int GetTimeShift() {
+            return _values.at(_section)->_timeShift;
+        }
+
+        float GetTimeShiftSpeed() {
+            return _values.at(_section)->_timeShiftSpeed;
+        }
+
+        DecimationMethodType GetDecimationMethod() {
+            return _values.at(_section)->_decimationMethod;
+        }
+
+        int GetFastConvolutionThreshold() {
+            return _values.at(_section)->_fastConvolutionThreshold;
+        }
+
+        int GetChannelizerChannels() {
+            return _values.at(_section)->_channelizerChannels;
+        }
+
+        int GetRfFftSize() {
+            return _values.at(_section)->_rfFftSize;
+        }
+
+        void SetRfFftSize(int size) {
+            _values.at(_section)->_rfFftSize = size;
+        }
+
+        int GetRfFftOverlap() {
+            return _values.at(_section)->_rfFftOverlap;
+        }
+
+        void SetRfFftOverlap(int overlap) {
+            _values.at(_section)->_rfFftOverlap = overlap;
+        }
+
+        int GetRfFftAveraging() {
+            return _values.at(_section)->_rfFftAveraging;
+        }
+
+        void SetRfFftAveraging(int averaging) {
+            _values.at(_section)->_rfFftAveraging = averaging;
+        }
+
+        int GetAfFftSize() {
+            return _values.at(_section)->_afFftSize;
+        }
+
+        void SetAfFftSize(int size) {
+            _values.at(_section)->_afFftSize = size;
+        }
+
+        int GetAfFftOverlap() {
+            return _values.at(_section)->_afFftOverlap;
+        }
+
+        void SetAfFftOverlap(int overlap) {
+            _values.at(_section)->_afFftOverlap = overlap;
+        }
+
+        int GetAfFftAveraging() {
+            return _values.at(_section)->_afFftAveraging;
+        }
+
+        void SetAfFftAveraging(int averaging) {
+            _values.at(_section)->_afFftAveraging = averaging;
+        }
+
+        int GetSpectrumTimeout() {
+            return _values.at(_section)->_spectrumTimeout;
+        }
+
+        int GetBlocksize() {
+            return _values.at(_section)->_blocksize;
+        }
+
+        int GetMemoryPool() {
+            return _values.at(_section)->_memoryPool;
+        }
+
+        bool GetPersistFilterDesigns() {
+            return _values.at(_section)->_persistFilterDesigns;
+        }
+
+        bool GetMemoryPoolHugePages() {
+            return _values.at(_section)->_memoryPoolHugePages;
+        }
+
+        bool GetMemoryPoolLock() {
+            return _values.at(_section)->_memoryPoolLock;
+        }
+
         int GetDecimatorAgcLevel() {
             return _values.at(_section)->_decimatorAgcLevel;
         }
@@ -1,6 +1,8 @@
 #ifndef __CONFIGOPTIONVALUES_H
 #define __CONFIGOPTIONVALUES_H
 
+#include "booma.h"
+
 /** Type of input device */
 enum InputSourceType {
     NO_INPUT_SOURCE_TYPE = 0,
@@ -31,10 +33,18 @@ enum ReceiverModeType {
     SSB = 4
 };
 
+/** Method used to decimate high rate input */
+enum DecimationMethodType {
+    FIR_DECIMATION = 0,
+    POLYPHASE_DECIMATION = 1,
+    CIC_DECIMATION = 2
+};
+
 /** Format of the dump file */
 enum DumpFileFormatType {
     PCM = 0,
-    WAV = 1
+    WAV = 1,
+    SIGMF = 2
 };
 
  class ConfigOptionValues {
@@ -73,9 +83,14 @@ enum DumpFileFormatType {
              _signalGeneratorFrequency = other->_signalGeneratorFrequency;
              _pcmFile = other->_pcmFile;
              _wavFile = other->_wavFile;
+             _inputFileSpeed = other->_inputFileSpeed;
+             _inputFileLoop = other->_inputFileLoop;
              _frequencyAlign = other->_frequencyAlign;
              _frequencyAlignVolume = other->_frequencyAlignVolume;
              _enableProbes = other->_enableProbes;
+             _enableBlockTiming = other->_enableBlockTiming;
+             _enableProfiling = other->_enableProfiling;
+             _enableLatency = other->_enableLatency;
              _reservedBuffers = other->_reservedBuffers;
              _receiverOptions = other->_receiverOptions;
              _receiverOptionsFor = other->_receiverOptionsFor;
@@ -86,6 +101,30 @@ enum DumpFileFormatType {
              _rtlsdrCorrectionFactor = other->_rtlsdrCorrectionFactor;
              _rtlsdrGain = other->_rtlsdrGain;
              _firFilterSize = other->_firFilterSize;
+             _inputThreadBlocks = other->_inputThreadBlocks;
+             _decimationMethod = other->_decimationMethod;
+             _fastConvolutionThreshold = other->_fastConvolutionThreshold;
+             _channelizerChannels = other->_channelizerChannels;
+             _rfFftSize = other->_rfFftSize;
+             _rfFftOverlap = other->_rfFftOverlap;
+             _rfFftAveraging = other->_rfFftAveraging;
+             _afFftSize = other->_afFftSize;
+             _afFftOverlap = other->_afFftOverlap;
+             _afFftAveraging = other->_afFftAveraging;
+             _spectrumTimeout = other->_spectrumTimeout;
+             _memoryPool = other->_memoryPool;
+             _blocksize = other->_blocksize;
+             _memoryPoolHugePages = other->_memoryPoolHugePages;
+             _memoryPoolLock = other->_memoryPoolLock;
+             _persistFilterDesigns = other->_persistFilterDesigns;
+             _dumpThreadBlocks = other->_dumpThreadBlocks;
+             _dumpRotateSize = other->_dumpRotateSize;
+             _dumpRotateDuration = other->_dumpRotateDuration;
+             _dumpPreroll = other->_dumpPreroll;
+             _triggerLevel = other->_triggerLevel;
+             _triggerHold = other->_triggerHold;
+             _timeShift = other->_timeShift;
+             _timeShiftSpeed = other->_timeShiftSpeed;
              _inputFilterWidth = other->_inputFilterWidth;
              _channels = other->_channels;
          }
@@ -148,9 +187,14 @@ enum DumpFileFormatType {
         int _signalGeneratorFrequency = -1;
         std::string _pcmFile = "";
         std::string _wavFile = "";
+        float _inputFileSpeed = 0; // times realtime, 0 = as fast as possible
+        bool _inputFileLoop = false;
         bool _frequencyAlign = false;
         int _frequencyAlignVolume = 500;
         bool _enableProbes = false;
+        bool _enableBlockTiming = false;
+        bool _enableProfiling = false;
+        bool _enableLatency = false;
         bool _verbose = false;
 
         // Buffered output
@@ -171,6 +215,30 @@ enum DumpFileFormatType {
         int _rtlsdrCorrectionFactor = 0;
         int _rtlsdrGain = 0;
         int _firFilterSize = 51;
+        int _inputThreadBlocks = 0; // = run in the processor thread
+        DecimationMethodType _decimationMethod = FIR_DECIMATION;
+        int _fastConvolutionThreshold = 512; // 0 = never
+        int _channelizerChannels = 8;
+        int _rfFftSize = 1024;
+        int _rfFftOverlap = 0; // percent
+        int _rfFftAveraging = 4;
+        int _afFftSize = 256;
+        int _afFftOverlap = 0; // percent
+        int _afFftAveraging = 2;
+        int _spectrumTimeout = 2000; // milliseconds, 0 = always calculate spectrums
+        int _memoryPool = 0; // MB, 0 = working buffers are taken from the heap
+        int _blocksize = BLOCKSIZE;
+        bool _memoryPoolHugePages = false;
+        bool _memoryPoolLock = false;
+        bool _persistFilterDesigns = false;
+        int _dumpThreadBlocks = 0; // 0 = write dumps from the processing thread
+        int _dumpRotateSize = 0; // MB, 0 = no limit
+        int _dumpRotateDuration = 0; // seconds, 0 = no limit
+        int _dumpPreroll = 10; // seconds kept in front of the dump breakers
+        int _triggerLevel = -1; // S units, -1 = dumps are not triggered
+        int _triggerHold = 5; // seconds
+        int _timeShift = 0; // seconds, 0 = no time shift buffer
+        float _timeShiftSpeed = 2; // max times real time when catching up, 0 for no limit
         int _rfAgcLevel = 500;
         int _decimatorAgcLevel = 1000;
         int _afFftAgcLevel = 150;